@@ -45,6 +45,14 @@ namespace utils {
  * in YAML or JSON format, including parsing, emitting, and traversing data trees.
  */
 
+/**
+ * @defgroup Expressions Expressions
+ * @brief Module for compiling and evaluating contract expressions.
+ *
+ * This group includes classes for parsing expression strings, e.g., assumptions and
+ * guarantees of contracts, into bytecode and evaluating them on value vectors.
+ */
+
 /**
  * @defgroup Logging Logging
  * @brief Module for logging and output formatting.
@@ -0,0 +1,159 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/async_file_writer.h
+ * @brief Definition of the class AsyncFileWriter.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "icarus/utils/system_ops.h"
+
+namespace icarus::utils {
+
+/**
+ * @brief Options of an asynchronous file writer.
+ * @ingroup SystemOps
+ */
+struct AsyncWriteOptions {
+    /// Number of writer threads.
+    size_t num_threads = 2;
+    /// Maximum number of files taken from the queue and written together by one thread.
+    size_t max_batch_size = 32;
+    /// Flag to flush each batch to the disk before completing its futures.
+    bool is_synced = false;
+    /// Mode of writing the files.
+    WriteMode mode = WriteMode::kTruncate;
+};
+
+/**
+ * @brief Write-behind service writing files on background threads.
+ *
+ * Callers hand over the content by move and continue immediately; the writes are queued
+ * and taken in batches by the writer threads. With AsyncWriteOptions::is_synced, each
+ * written file (and, for atomic writes, its directory) is synced to the disk before its
+ * future is completed; a failed sync is reported as the error of that write.
+ * Content buffers are recycled and can be reused for the next outputs with
+ * acquireBuffer(). Writes to the same path must be separated by flush(), as they may
+ * otherwise be written by different threads in any order.
+ * @ingroup SystemOps
+ */
+class AsyncFileWriter {
+public:
+    /**
+     * @brief Creates a writer and starts its threads.
+     *
+     * @param options [opt] Options of the writer.
+     */
+    explicit AsyncFileWriter(AsyncWriteOptions options = {});
+
+    /**
+     * @brief Writes all queued files and stops the threads.
+     */
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * @brief Queues the writing of a file.
+     *
+     * @param file_path Path of the file to write.
+     * @param content Content of the file, taken over by the writer.
+     * @returns Future of the result of writeBuffersToFile (true if written, false if
+     *          skipped), holding its std::runtime_error on failure.
+     */
+    std::future<bool> write(std::string file_path, std::string content);
+
+    /**
+     * @brief Queues the writing of the concatenation of several buffers to a file.
+     *
+     * @param file_path Path of the file to write.
+     * @param buffers Buffers to write in order, taken over by the writer.
+     * @returns Future of the result of writeBuffersToFile.
+     */
+    std::future<bool> write(std::string file_path, std::vector<std::string> buffers);
+
+    /**
+     * @brief Returns an empty buffer, reusing the storage of already written content.
+     *
+     * @returns Empty string, possibly with reserved capacity.
+     */
+    std::string acquireBuffer();
+
+    /**
+     * @brief Waits until all queued files are written (and synced, if enabled).
+     */
+    void flush();
+
+    /**
+     * @brief Returns the number of queued or running writes.
+     *
+     * @returns Number of pending writes.
+     */
+    size_t getNumPending() const;
+
+private:
+    /**
+     * @brief Queued write with the promise of its result.
+     */
+    struct Job {
+        std::string file_path;             ///< Path of the file to write.
+        std::vector<std::string> buffers;  ///< Content of the file.
+        std::promise<bool> promise;        ///< Promise of the result.
+    };
+
+    /**
+     * @brief Appends a job to the queue.
+     *
+     * @param job Job to queue.
+     * @returns Future of the result of the job.
+     */
+    std::future<bool> enqueue(Job job);
+
+    /**
+     * @brief Loop of a writer thread writing batches until the writer is stopped.
+     */
+    void run();
+
+    /**
+     * @brief Keeps the buffers of a written job for reuse.
+     *
+     * @param buffers Buffers of the job.
+     */
+    void recycleBuffers(std::vector<std::string>& buffers);
+
+    /// Maximum number of buffers kept for reuse.
+    static constexpr size_t kMaxFreeBuffers = 64;
+    /// Minimum capacity of a buffer to be kept for reuse.
+    static constexpr size_t kMinRecycledCapacity = 4096;
+
+    /// Options of the writer.
+    AsyncWriteOptions options_;
+    /// Writer threads.
+    std::vector<std::thread> workers_;
+    /// Queued jobs.
+    std::deque<Job> jobs_;
+    /// Buffers kept for reuse.
+    std::vector<std::string> free_buffers_;
+    /// Number of queued or running jobs.
+    size_t num_pending_ = 0;
+    /// Mutex protecting the queue, the buffers, the counter and the stop flag.
+    mutable std::mutex mutex_;
+    /// Condition variable signaling new jobs or stopping.
+    std::condition_variable cv_;
+    /// Condition variable signaling written jobs.
+    std::condition_variable done_cv_;
+    /// Flag to stop the threads once the queue is empty.
+    bool is_stopping_ = false;
+};
+
+} // namespace icarus::utils
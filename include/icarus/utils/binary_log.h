@@ -0,0 +1,518 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/binary_log.h
+ * @brief Definition of the class BinaryLogger and of the binary logging macros.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "icarus/utils/logging_module.h"
+
+namespace icarus {
+
+/**
+ * @brief Type of an argument stored in a binary log record.
+ *
+ * @ingroup Logging
+ */
+enum class BinaryArgType : uint8_t {
+    kBool,    ///< Boolean (1 byte).
+    kChar,    ///< Character (1 byte).
+    kInt,     ///< Signed integer or enumeration (8 bytes).
+    kUInt,    ///< Unsigned integer (8 bytes).
+    kDouble,  ///< Floating-point number (8 bytes).
+    kString,  ///< String, copied with its length (4 bytes + characters).
+    kPointer  ///< Pointer, stored as address (8 bytes).
+};
+
+/**
+ * @brief Registered log statement: level, format string, source location and argument types.
+ *
+ * @ingroup Logging
+ */
+struct BinaryLogFormat {
+    spdlog::level::level_enum level = spdlog::level::info;  ///< Level of the statement.
+    std::string format;                                     ///< fmt format string.
+    std::string file;                                       ///< Source file.
+    int line = 0;                                           ///< Source line.
+    std::string function;                                   ///< Function name.
+    std::vector<BinaryArgType> arg_types;                   ///< Types of the arguments.
+};
+
+/**
+ * @brief Configuration of a binary logger.
+ *
+ * @ingroup Logging
+ */
+struct BinaryLogConfig {
+    /// Capacity in bytes of the ring buffer of each logging thread (rounded up to a power of two).
+    size_t ring_size = 1 << 20;
+    /// Flag to wait for free space if a ring buffer is full instead of dropping the record.
+    bool is_blocking = false;
+    /// Interval in which the background thread drains the ring buffers.
+    std::chrono::milliseconds poll_interval{1};
+};
+
+/**
+ * @brief Logger deferring the formatting of messages to a background thread or to an offline decoder.
+ *
+ * Each log statement is registered once with its format string, source location and
+ * argument types (see ICARUS_BLOG). Afterwards, a call only copies the format ID, a
+ * timestamp and the raw arguments into a lock-free single-producer ring buffer owned by
+ * the calling thread. The background thread drains the rings and either formats the
+ * records and passes them to the sinks of an spdlog logger (keeping the time and thread ID
+ * of the call), or appends them to a binary file decoded later with decodeFile().
+ *
+ * Records of different threads are written in the order in which the rings are drained,
+ * so they are only ordered by time within each thread. Binary files contain native byte
+ * order and must be decoded on the same architecture. The logger must outlive all calls.
+ * @ingroup Logging
+ */
+class BinaryLogger {
+public:
+    /**
+     * @brief Creates a binary logger formatting the records in the background.
+     *
+     * @param logger spdlog logger whose sinks receive the formatted messages (its level is
+     *        used as initial level).
+     * @param config [opt] Configuration of the logger.
+     * @throws std::runtime_error If the logger is null.
+     */
+    explicit BinaryLogger(std::shared_ptr<spdlog::logger> logger, BinaryLogConfig config = {});
+
+    /**
+     * @brief Creates a binary logger writing the records into a binary file.
+     *
+     * @param file_path Path of the binary log file (overwritten).
+     * @param config [opt] Configuration of the logger.
+     * @throws std::runtime_error If the file cannot be opened.
+     */
+    explicit BinaryLogger(const std::string& file_path, BinaryLogConfig config = {});
+
+    /**
+     * @brief Writes all pending records and stops the background thread.
+     */
+    ~BinaryLogger();
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    /**
+     * @brief Checks whether a level is enabled (one relaxed atomic load).
+     *
+     * @param level Level of a statement.
+     * @returns True if statements of the level are recorded.
+     */
+    bool shouldLog(spdlog::level::level_enum level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the minimum level of the recorded statements.
+     *
+     * @param level Minimum level.
+     */
+    void setLevel(spdlog::level::level_enum level);
+
+    /**
+     * @brief Returns the minimum level of the recorded statements.
+     *
+     * @returns Minimum level.
+     */
+    spdlog::level::level_enum getLevel() const;
+
+    /**
+     * @brief Records a registered statement with its arguments.
+     *
+     * Called by ICARUS_BLOG, which checks the level and registers the format beforehand.
+     *
+     * @param format_id ID returned by registerFormat().
+     * @param format Format string (only used for the deduction of the argument types).
+     * @param args Arguments of the statement.
+     */
+    template<size_t N, typename... Args>
+    void log(uint32_t format_id, const char (&format)[N], const Args&... args) {
+        (void)format;
+        size_t size = sizeof(RecordHeader) + (getEncodedSize(args) + ... + 0);
+        size = (size + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+        char* record = reserveRecord(size);
+        if (record == nullptr) {
+            return;  // Dropped
+        }
+
+        RecordHeader header{static_cast<uint32_t>(size), format_id,
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now().time_since_epoch()).count()};
+        std::memcpy(record, &header, sizeof(header));
+        [[maybe_unused]] char* pos = record + sizeof(header);
+        (encodeArg(pos, args), ...);
+        commitRecord(size);
+    }
+
+    /**
+     * @brief Waits until all records logged before the call are written, and flushes the output.
+     */
+    void flush();
+
+    /**
+     * @brief Returns the number of records dropped because a ring buffer was full.
+     *
+     * @returns Number of dropped records.
+     */
+    size_t getNumDroppedRecords() const;
+
+    /**
+     * @brief Returns the number of ring buffers, i.e., of running threads which logged.
+     *
+     * The ring buffer of an exited thread is removed once all its records are drained.
+     *
+     * @returns Number of ring buffers.
+     */
+    size_t getNumRingBuffers() const;
+
+    /**
+     * @brief Registers a log statement.
+     *
+     * @param level Level of the statement.
+     * @param format fmt format string.
+     * @param file Source file.
+     * @param line Source line.
+     * @param function Function name.
+     * @param arg_types Types of the arguments.
+     * @returns ID of the format, valid for the whole process.
+     */
+    static uint32_t registerFormat(spdlog::level::level_enum level, const char* format,
+                                   const char* file, int line, const char* function,
+                                   std::vector<BinaryArgType> arg_types);
+
+    /**
+     * @brief Returns a registered log statement.
+     *
+     * @param format_id ID returned by registerFormat().
+     * @returns Reference to the format, valid for the whole process.
+     * @throws std::runtime_error If the ID is not registered.
+     */
+    static const BinaryLogFormat& getFormat(uint32_t format_id);
+
+    /**
+     * @brief Decodes a binary log file and passes its messages to the sinks of a logger.
+     *
+     * @param file_path Path of the binary log file.
+     * @param logger spdlog logger whose sinks receive the formatted messages.
+     * @returns Number of decoded records.
+     * @throws std::runtime_error If the file cannot be read or is not a valid binary log.
+     */
+    static size_t decodeFile(const std::string& file_path,
+                             const std::shared_ptr<spdlog::logger>& logger);
+
+    /**
+     * @brief List of argument types of a statement, deduced by makeArgTypes().
+     */
+    template<typename... Args>
+    struct ArgTypeList {
+        /**
+         * @brief Returns the types of the arguments.
+         *
+         * @returns Argument types.
+         */
+        static std::vector<BinaryArgType> get() {
+            return {getArgType<std::decay_t<Args>>()...};
+        }
+    };
+
+    /**
+     * @brief Deduces the argument types of a statement (only used in unevaluated context).
+     */
+    template<size_t N, typename... Args>
+    static ArgTypeList<Args...> makeArgTypes(const char (&format)[N], const Args&... args);
+
+    /**
+     * @brief Returns the binary type of an argument type.
+     *
+     * @returns Binary type.
+     */
+    template<typename T>
+    static constexpr BinaryArgType getArgType() {
+        if constexpr (std::is_same_v<T, bool>) {
+            return BinaryArgType::kBool;
+        }
+        else if constexpr (std::is_same_v<T, char>) {
+            return BinaryArgType::kChar;
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            return BinaryArgType::kInt;
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            return std::is_signed_v<T> ? BinaryArgType::kInt : BinaryArgType::kUInt;
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            return BinaryArgType::kDouble;
+        }
+        else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                           std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+            return BinaryArgType::kString;
+        }
+        else {
+            static_assert(std::is_pointer_v<T>, "Type not supported by binary logging");
+            return BinaryArgType::kPointer;
+        }
+    }
+
+private:
+    class RingBuffer;
+
+    /**
+     * @brief Header of a record in a ring buffer, followed by the encoded arguments.
+     */
+    struct RecordHeader {
+        uint32_t size;       ///< Size of the record in bytes (including header and padding).
+        uint32_t format_id;  ///< ID of the format.
+        int64_t time;        ///< Time of the call in nanoseconds since the Unix epoch.
+    };
+
+    /// Alignment of the records in a ring buffer (a padding record needs a full header).
+    static constexpr size_t kRecordAlignment = 16;
+
+    /**
+     * @brief Returns a string argument as view.
+     *
+     * @param arg String argument.
+     * @returns View of the string.
+     */
+    template<typename T>
+    static std::string_view toStringView(const T& arg) {
+        if constexpr (std::is_pointer_v<T>) {
+            return (arg != nullptr) ? std::string_view(arg) : std::string_view("(null)");
+        }
+        else {
+            return std::string_view(arg);
+        }
+    }
+
+    /**
+     * @brief Returns the number of bytes of an encoded argument.
+     *
+     * @param arg Argument.
+     * @returns Encoded size.
+     */
+    template<typename T>
+    static size_t getEncodedSize(const T& arg) {
+        constexpr BinaryArgType type = getArgType<std::decay_t<T>>();
+        if constexpr (type == BinaryArgType::kString) {
+            return sizeof(uint32_t) + toStringView(arg).size();
+        }
+        else if constexpr (type == BinaryArgType::kBool || type == BinaryArgType::kChar) {
+            return 1;
+        }
+        else {
+            return 8;
+        }
+    }
+
+    /**
+     * @brief Encodes an argument into a record.
+     *
+     * @param pos Position in the record, advanced behind the argument.
+     * @param arg Argument.
+     */
+    template<typename T>
+    static void encodeArg(char*& pos, const T& arg) {
+        constexpr BinaryArgType type = getArgType<std::decay_t<T>>();
+        if constexpr (type == BinaryArgType::kString) {
+            std::string_view view = toStringView(arg);
+            uint32_t length = static_cast<uint32_t>(view.size());
+            std::memcpy(pos, &length, sizeof(length));
+            std::memcpy(pos + sizeof(length), view.data(), view.size());
+            pos += sizeof(length) + view.size();
+        }
+        else if constexpr (type == BinaryArgType::kBool || type == BinaryArgType::kChar) {
+            *pos++ = static_cast<char>(arg);
+        }
+        else {
+            if constexpr (type == BinaryArgType::kInt) {
+                int64_t value = static_cast<int64_t>(arg);
+                std::memcpy(pos, &value, 8);
+            }
+            else if constexpr (type == BinaryArgType::kUInt) {
+                uint64_t value = static_cast<uint64_t>(arg);
+                std::memcpy(pos, &value, 8);
+            }
+            else if constexpr (type == BinaryArgType::kDouble) {
+                double value = static_cast<double>(arg);
+                std::memcpy(pos, &value, 8);
+            }
+            else {
+                uint64_t value = reinterpret_cast<uintptr_t>(arg);
+                std::memcpy(pos, &value, 8);
+            }
+            pos += 8;
+        }
+    }
+
+    /**
+     * @brief Assigns the ID of the logger, normalizes the configuration and starts the background thread.
+     */
+    void start();
+
+    /**
+     * @brief Reserves space for a record in the ring buffer of the calling thread.
+     *
+     * @param size Size of the record in bytes.
+     * @returns Pointer to the reserved space, nullptr if the record is dropped.
+     */
+    char* reserveRecord(size_t size);
+
+    /**
+     * @brief Publishes the record reserved last by the calling thread.
+     *
+     * @param size Size of the record in bytes.
+     */
+    void commitRecord(size_t size);
+
+    /**
+     * @brief Returns the ring buffer of the calling thread, creating it if needed.
+     *
+     * @returns Reference to the ring buffer.
+     */
+    RingBuffer& getThreadRing();
+
+    /**
+     * @brief Loop of the background thread draining the ring buffers until the logger is stopped.
+     */
+    void run();
+
+    /**
+     * @brief Writes all published records of the ring buffers to the output.
+     *
+     * @param rings Ring buffers to drain.
+     */
+    void drain(const std::vector<std::shared_ptr<RingBuffer>>& rings);
+
+    /// Unique ID of the logger, identifying its ring buffers in the calling threads.
+    uint64_t id_;
+    /// Configuration of the logger.
+    BinaryLogConfig config_;
+    /// Minimum level of the recorded statements.
+    std::atomic<int> level_{spdlog::level::info};
+    /// spdlog logger receiving the formatted messages (nullptr: file output).
+    std::shared_ptr<spdlog::logger> logger_;
+    /// Binary log file (nullptr: logger output).
+    std::FILE* file_ = nullptr;
+    /// Flags whether the definition of each format was written to the file.
+    std::vector<bool> written_formats_;
+    /// Ring buffers of all threads that used the logger.
+    std::vector<std::shared_ptr<RingBuffer>> rings_;
+    /// Number of dropped records.
+    std::atomic<size_t> num_dropped_{0};
+    /// Number of completed drains of the background thread.
+    uint64_t num_drains_ = 0;
+    /// Number of drains requested by flush() (drains without waiting while not reached).
+    uint64_t flush_target_ = 0;
+    /// Flag to stop the background thread after a last drain.
+    bool is_stopping_ = false;
+    /// Mutex protecting the ring list, the counter and the flags.
+    mutable std::mutex mutex_;
+    /// Condition variable waking the background thread.
+    std::condition_variable cv_;
+    /// Condition variable signaling completed drains.
+    std::condition_variable done_cv_;
+    /// Background thread.
+    std::thread worker_;
+};
+
+} // namespace icarus
+
+/**
+ * @defgroup BinaryLogMacros Binary logging macros
+ * @ingroup Logging
+ * @brief Macros recording messages with the binary logger of a LoggingModule.
+ *
+ * Usage like ICARUS_LOG_*, e.g., `ICARUS_BLOG_INFO(*this, "Step {} took {} s", step, time)`.
+ * The format string must be a literal. Supported arguments are booleans, characters,
+ * integers, enumerations, floating-point numbers, strings and pointers. Statements below
+ * ICARUS_LOG_ACTIVE_LEVEL are removed at compile time, and the arguments are only
+ * evaluated if the level of the binary logger is enabled.
+ * @{
+ */
+
+/// Expands its argument (required for __VA_ARGS__ with the traditional MSVC preprocessor).
+#define ICARUS_BLOG_EXPAND(x) x
+/// Returns the format string, i.e., the first argument, of a statement.
+#define ICARUS_BLOG_FORMAT(...) ICARUS_BLOG_EXPAND(ICARUS_BLOG_FORMAT_(__VA_ARGS__, unused))
+/// Helper of ICARUS_BLOG_FORMAT.
+#define ICARUS_BLOG_FORMAT_(format, ...) format
+
+/**
+ * @brief Records a message with the binary logger of a logging module if the level is enabled.
+ *
+ * The statement is registered on its first execution.
+ *
+ * @param module Logging module (object or reference, e.g., `*this`).
+ * @param log_level spdlog level of the message.
+ * @param ... Format string literal and its arguments.
+ */
+#define ICARUS_BLOG(module, log_level, ...)                                                        \
+    do {                                                                                           \
+        icarus::BinaryLogger* icarus_blog_logger_ = (module).getBinaryLogger().get();              \
+        if (icarus_blog_logger_ != nullptr && icarus_blog_logger_->shouldLog(log_level)) {         \
+            static const uint32_t icarus_blog_format_id_ = icarus::BinaryLogger::registerFormat(   \
+                log_level, ICARUS_BLOG_FORMAT(__VA_ARGS__), __FILE__, __LINE__, SPDLOG_FUNCTION,   \
+                decltype(icarus::BinaryLogger::makeArgTypes(__VA_ARGS__))::get());                 \
+            icarus_blog_logger_->log(icarus_blog_format_id_, __VA_ARGS__);                         \
+        }                                                                                          \
+    } while (0)
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+    #define ICARUS_BLOG_TRACE(module, ...) ICARUS_BLOG(module, spdlog::level::trace, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_TRACE(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+    #define ICARUS_BLOG_DEBUG(module, ...) ICARUS_BLOG(module, spdlog::level::debug, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_DEBUG(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+    #define ICARUS_BLOG_INFO(module, ...) ICARUS_BLOG(module, spdlog::level::info, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_INFO(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+    #define ICARUS_BLOG_WARN(module, ...) ICARUS_BLOG(module, spdlog::level::warn, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_WARN(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+    #define ICARUS_BLOG_ERROR(module, ...) ICARUS_BLOG(module, spdlog::level::err, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_ERROR(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+    #define ICARUS_BLOG_CRITICAL(module, ...) ICARUS_BLOG(module, spdlog::level::critical, __VA_ARGS__)
+#else
+    #define ICARUS_BLOG_CRITICAL(module, ...) (void)0
+#endif
+
+/// @}
@@ -0,0 +1,257 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/column_table.h
+ * @brief Definition of the class ColumnTable.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "icarus/utils/data_node.h"
+
+namespace icarus {
+
+/**
+ * @brief Columnar, typed representation of a sequence of maps, e.g., a signal table.
+ *
+ * Each key of the maps becomes a column with one contiguous array of values and a null
+ * mask. The type of a column is inferred from all its cells and widened as needed:
+ * bool, int (64 bit) and float (double) columns are stored natively, mixed columns as
+ * strings. Missing keys and null values (`~`, `null`, empty) are marked in the mask.
+ * @ingroup StructuredData
+ */
+class ColumnTable {
+public:
+    /**
+     * @brief Type of a column, in widening order from kNull to kString.
+     */
+    enum class ColumnType : uint8_t {
+        kNull,    ///< Only null cells.
+        kBool,    ///< Boolean values (stored as uint8_t).
+        kInt,     ///< Integer values (stored as int64_t).
+        kFloat,   ///< Floating-point values (stored as double).
+        kString   ///< String values.
+    };
+
+    /**
+     * @brief Typed column of a table.
+     *
+     * Only the array matching the type of the column is filled. Null cells hold a
+     * default value (0, false or an empty string) in the array.
+     */
+    class Column {
+    public:
+        /**
+         * @brief Returns the name (key) of the column.
+         *
+         * @returns Name of the column.
+         */
+        const std::string& getName() const { return name_; }
+
+        /**
+         * @brief Returns the type of the column.
+         *
+         * @returns Type of the column.
+         */
+        ColumnType getType() const { return type_; }
+
+        /**
+         * @brief Checks whether a cell of the column is null.
+         *
+         * @param row Index of the row.
+         * @returns True if the cell is null, false otherwise.
+         */
+        bool isNull(size_t row) const { return nulls_[row] != 0; }
+
+        /**
+         * @brief Returns the null mask of the column (1 for null cells).
+         *
+         * @returns Null mask with one byte per row.
+         */
+        const std::vector<uint8_t>& getNullMask() const { return nulls_; }
+
+        /**
+         * @brief Returns the number of null cells of the column.
+         *
+         * @returns Number of null cells.
+         */
+        size_t getNullCount() const;
+
+        /**
+         * @brief Returns the values of a bool column.
+         *
+         * @returns Values (0 or 1) of the column.
+         * @throws std::runtime_error If the column is not of type kBool.
+         */
+        const std::vector<uint8_t>& getBools() const;
+
+        /**
+         * @brief Returns the values of an int column.
+         *
+         * @returns Values of the column.
+         * @throws std::runtime_error If the column is not of type kInt.
+         */
+        const std::vector<int64_t>& getInts() const;
+
+        /**
+         * @brief Returns the values of a float column.
+         *
+         * @returns Values of the column.
+         * @throws std::runtime_error If the column is not of type kFloat.
+         */
+        const std::vector<double>& getFloats() const;
+
+        /**
+         * @brief Returns the values of a string column.
+         *
+         * @returns Values of the column.
+         * @throws std::runtime_error If the column is not of type kString.
+         */
+        const std::vector<std::string>& getStrings() const;
+
+    private:
+        friend class ColumnTable;
+
+        /**
+         * @brief Throws if the column does not have the given type.
+         */
+        void checkType(ColumnType type) const;
+
+        /// Name (key) of the column.
+        std::string name_;
+        /// Type of the column.
+        ColumnType type_ = ColumnType::kNull;
+        /// Null mask (1 for null cells).
+        std::vector<uint8_t> nulls_;
+        /// Values of a bool column.
+        std::vector<uint8_t> bools_;
+        /// Values of an int column.
+        std::vector<int64_t> ints_;
+        /// Values of a float column.
+        std::vector<double> floats_;
+        /// Values of a string column.
+        std::vector<std::string> strings_;
+    };
+
+    /**
+     * @brief Constructs an empty table.
+     */
+    ColumnTable() = default;
+
+    /**
+     * @brief Converts a sequence of maps into a columnar table.
+     *
+     * Columns are ordered by first appearance of their keys. Quoted numbers are not
+     * distinguished from plain ones, i.e., they are inferred as numbers as well.
+     *
+     * @param seq Data node (sequence) of maps with scalar values.
+     * @returns Table with one row per element of the sequence.
+     * @throws std::runtime_error If the node is not a sequence of maps with scalar values.
+     */
+    static ColumnTable fromDataNode(const DataNode& seq);
+
+    /**
+     * @brief Emits the table as a sequence of maps, writing null cells as `~`.
+     *
+     * @returns Data node (sequence) with one map per row.
+     */
+    DataNode toDataNode() const;
+
+    /**
+     * @brief Adds a bool column.
+     *
+     * @param name Name of the column.
+     * @param values Values of the column.
+     * @param nulls [opt] Null mask (1 for null cells), empty for no null cells.
+     * @throws std::runtime_error If the name exists or the sizes do not match the rows.
+     */
+    void addColumn(const std::string& name, const std::vector<bool>& values,
+                   std::vector<uint8_t> nulls = {});
+
+    /**
+     * @brief Adds an int column.
+     *
+     * @copydetails addColumn(const std::string&, const std::vector<bool>&, std::vector<uint8_t>)
+     */
+    void addColumn(const std::string& name, std::vector<int64_t> values,
+                   std::vector<uint8_t> nulls = {});
+
+    /**
+     * @brief Adds a float column.
+     *
+     * @copydetails addColumn(const std::string&, const std::vector<bool>&, std::vector<uint8_t>)
+     */
+    void addColumn(const std::string& name, std::vector<double> values,
+                   std::vector<uint8_t> nulls = {});
+
+    /**
+     * @brief Adds a string column.
+     *
+     * @copydetails addColumn(const std::string&, const std::vector<bool>&, std::vector<uint8_t>)
+     */
+    void addColumn(const std::string& name, std::vector<std::string> values,
+                   std::vector<uint8_t> nulls = {});
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @returns Number of rows.
+     */
+    size_t getNumRows() const;
+
+    /**
+     * @brief Returns the number of columns.
+     *
+     * @returns Number of columns.
+     */
+    size_t getNumColumns() const;
+
+    /**
+     * @brief Checks whether the table has a column with a given name.
+     *
+     * @param name Name of the column.
+     * @returns True if the column exists, false otherwise.
+     */
+    bool hasColumn(const std::string& name) const;
+
+    /**
+     * @brief Returns a column by index.
+     *
+     * @param index Index of the column.
+     * @returns Reference to the column.
+     */
+    const Column& getColumn(size_t index) const;
+
+    /**
+     * @brief Returns a column by name.
+     *
+     * @param name Name of the column.
+     * @returns Reference to the column.
+     * @throws std::runtime_error If the table has no column with the name.
+     */
+    const Column& getColumn(const std::string& name) const;
+
+private:
+    /**
+     * @brief Appends a column after checking its name and sizes.
+     *
+     * @param column Column with name, type and values.
+     * @param num_values Number of values of the column.
+     * @throws std::runtime_error If the name exists or the sizes do not match the rows.
+     */
+    void appendColumn(Column column, size_t num_values);
+
+    /// Columns in order.
+    std::vector<Column> columns_;
+    /// Index of each column name in columns_.
+    std::unordered_map<std::string, size_t> column_ids_;
+    /// Number of rows.
+    size_t num_rows_ = 0;
+};
+
+} // namespace icarus
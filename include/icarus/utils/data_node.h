@@ -7,17 +7,27 @@
  */
 #pragma once
 
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <vector>
 
 #undef emit  // Common macro used for example in Qt.
 #include <ryml/ryml.hpp>
 #include <ryml/ryml_std.hpp>
 #define emit
 
+#include "icarus/utils/system_ops.h"
+
 namespace icarus {
 
+namespace utils {
+class Symbol;  // Defined in icarus/utils/symbol_pool.h, needed to use the symbol getters
+}
+
 /**
  * @brief Node in a YAML/JSON data structure.
  * 
@@ -44,6 +54,36 @@ public:
         kUndefined ///< Undefined type.
     };
 
+    /**
+     * @brief Memory and size statistics of a data node (sub)tree.
+     *
+     * Node counts, depth and widths refer to the subtree below the node, whereas
+     * capacities and arena sizes refer to the whole underlying tree.
+     */
+    struct Stats {
+        size_t num_nodes = 0;       ///< Number of nodes in the subtree (including the node itself).
+        size_t node_capacity = 0;   ///< Capacity of the node array of the tree.
+        size_t node_bytes = 0;      ///< Bytes reserved for the node array of the tree.
+        size_t arena_used = 0;      ///< Bytes used in the string arena of the tree.
+        size_t arena_reserved = 0;  ///< Bytes reserved for the string arena of the tree.
+        size_t max_depth = 0;       ///< Deepest nesting level below the node (0 for a leaf).
+        size_t max_map_width = 0;   ///< Largest number of children of a map in the subtree.
+        size_t max_seq_width = 0;   ///< Largest number of children of a sequence in the subtree.
+    };
+
+    /**
+     * @brief Options of the streaming emission of a data node, see DataNode::emitTo.
+     */
+    struct EmitOptions {
+        Format format = Format::kYaml;  ///< Format to emit the data node in.
+        bool is_compact = false;        ///< Flag to emit on a single line (flow style).
+        /// Number of nesting levels to emit below the node; deeper containers are elided.
+        size_t max_depth = std::numeric_limits<size_t>::max();
+    };
+
+    /// Callback receiving consecutive pieces of emitted output.
+    using EmitSink = std::function<void(std::string_view)>;
+
     /**
      * @brief Iterator for traversing the children of a data node.
      */
@@ -94,6 +134,8 @@ public:
     /**
      * @brief Constructs a DataNode object by parsing a local YAML/JSON file.
      * 
+     * Values tagged with `!include` are resolved, see DataNode::parseFromFile.
+     * 
      * @param file_path Path of the YAML/JSON file to read from.
      */
     explicit DataNode(const std::string& file_path);
@@ -122,7 +164,13 @@ public:
     /**
 	 * @brief Parses the data node from a YAML/JSON file.
 	 * 
+	 * Values tagged with `!include <path>` are replaced by the content of the referenced
+	 * file, whose path is relative to the including file. Each distinct included file is
+	 * parsed only once (independent files in parallel) and spliced into every node that
+	 * references it. Included files may include further files.
+	 * 
 	 * @param file_path Path of the file to parse the data from.
+	 * @throws std::runtime_error If a file cannot be read or parsed, or includes form a cycle.
 	 */
     void parseFromFile(const std::string& file_path);
 
@@ -194,6 +242,26 @@ public:
 
     DataNode operator[](size_t index);
 
+    /**
+     * @brief Appends a new child to the data node (sequence) in constant time.
+     *
+     * @returns Appended child node.
+     * @throws std::runtime_error If the node is not a sequence.
+     */
+    DataNode append();
+
+    /**
+     * @brief Appends a new child with a given key to the data node (map) in constant time.
+     *
+     * Unlike DataNode::operator[], the map is not searched for the key, which the caller
+     * must ensure to be new.
+     *
+     * @param key Key of the new child node.
+     * @returns Appended child node.
+     * @throws std::runtime_error If the node is not a map.
+     */
+    DataNode append(const std::string& key);
+
     template<typename T>
     T as() const {
         T value{};
@@ -212,6 +280,13 @@ public:
 		}
     }
 
+    /**
+     * @brief Sets the type of the data node, e.g., to nest maps or sequences in a new child.
+     *
+     * @param type Type to set (Type::kUndefined leaves the node unchanged).
+     */
+    void setType(Type type);
+
     /**
      * @brief Returns whether the data node is valid.
      *
@@ -254,6 +329,33 @@ public:
 	 */
     std::string getKey() const;
 
+    /**
+     * @brief Returns the key of the data node as a view into the tree buffer.
+     *
+     * The view remains valid as long as the tree is alive and the node is not modified.
+     *
+     * @returns View of the key (empty if the node has no key).
+     */
+    std::string_view getKeyView() const;
+
+    /**
+     * @brief Returns the scalar value of the data node as a view into the tree buffer.
+     *
+     * The view remains valid as long as the tree is alive and the node is not modified.
+     *
+     * @returns View of the value (empty if the node has no value, e.g., a container).
+     */
+    std::string_view getValView() const;
+
+    /**
+     * @brief Returns the key of the data node interned in the global symbol pool.
+     *
+     * Callers must include icarus/utils/symbol_pool.h.
+     *
+     * @returns Symbol of the key (empty if the node has no key).
+     */
+    utils::Symbol getKeySymbol() const;
+
     /**
      * @brief Returns the first child of the data node, if it has one.
      * 
@@ -275,6 +377,22 @@ public:
 	 */
     size_t getNumChildren() const;
 
+    /**
+     * @brief Computes the memory and size statistics of the (sub)tree of the data node.
+     *
+     * @returns Statistics of the data node, see DataNode::Stats.
+     * @throws std::runtime_error If the data node is invalid.
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Reserves memory in the underlying tree, e.g., using capacities of former loads.
+     *
+     * @param node_capacity Number of nodes to reserve.
+     * @param arena_capacity [opt] Number of bytes to reserve for the string arena.
+     */
+    void reserve(size_t node_capacity, size_t arena_capacity = 0);
+
     /**
 	 * @brief Prints the data node to the console.
 	 *  
@@ -282,14 +400,53 @@ public:
 	 */
     void print(Format format = Format::kYaml) const;
 
+    /**
+     * @brief Emits the data node piece by piece into a sink.
+     *
+     * Without compact style and depth limit, the output is the one of DataNode::emitStr
+     * without the trailing newline. Otherwise, a streaming emitter following the same
+     * quoting rules writes compact and depth-limited output without an intermediate
+     * string, e.g., for log messages (see icarus/utils/data_node_fmt.h). Elided
+     * containers are written as `{...}` or `[...]`.
+     *
+     * @param sink Callback receiving the emitted pieces in order.
+     * @param options Format, style and depth of the emission.
+     * @throws std::runtime_error If the data node is invalid.
+     */
+    void emitTo(const EmitSink& sink, const EmitOptions& options) const;
+
+    /**
+     * @brief Emits the data node to a string.
+     *
+     * With multiple threads, the children of a root map or sequence are split into chunks
+     * which are emitted in parallel and stitched together in order. The result is
+     * identical to the serial emission, which is used when called from a task of the
+     * shared pool.
+     *
+     * @param format [opt] Format to emit the data node in.
+     * @param num_threads [opt] Number of threads to emit with (0: all threads of the shared pool).
+     * @returns Emitted YAML/JSON content.
+     * @throws std::runtime_error If the data node is invalid.
+     */
+    std::string emitStr(Format format = Format::kYaml, size_t num_threads = 1) const;
+
     /**
      * @brief Writes the data spec to a YAML/JSON file.
      * 
+     * The emitted chunks are written with a single vectored write, see DataNode::emitStr
+     * for the parallel emission. With utils::WriteMode::kSkipUnchanged, files whose
+     * content would not change are not touched.
+     * 
      * @param output_file_path Path of the file to write the data spec to.
      * @param format [opt] Format to emit the data node in.
+     * @param num_threads [opt] Number of threads to emit with (0: all threads of the shared pool).
+     * @param mode [opt] Mode of writing the file.
+     * @returns True if the file was written, false if the write was skipped.
      * @throws std::runtime_error If the file cannot be opened for writing.
 	 */
-    void writeToFile(const std::string& output_file_path, Format format = Format::kYaml) const;
+    bool writeToFile(const std::string& output_file_path, Format format = Format::kYaml,
+                     size_t num_threads = 1,
+                     utils::WriteMode mode = utils::WriteMode::kTruncate) const;
 
     /**
      * @brief Gets child map with a given key from the data node, if it is a sequence.
@@ -307,7 +464,21 @@ public:
      */
     std::vector<std::string> getSeqStrings();
 
+    /**
+     * @brief Returns the elements of the sequence interned in the global symbol pool.
+     *
+     * Unlike getSeqStrings(), repeated names share one copy and compare as integers.
+     * Callers must include icarus/utils/symbol_pool.h.
+     *
+     * @returns Vector of symbols from the sequence.
+     * @throws std::runtime_error If the node is not a sequence.
+     */
+    std::vector<utils::Symbol> getSeqSymbols() const;
+
 private:
+    /// Parses sections of files directly into data node trees.
+    friend class LazyDataFile;
+
     /**
 	 * @brief Constructs a data node with a given tree and node ID.
 	 * 
@@ -316,6 +487,15 @@ private:
 	 */
     DataNode(std::shared_ptr<ryml::Tree> tree, size_t node_id);
 
+    /**
+     * @brief Replaces the !include values of the tree by the contents of the included files.
+     *
+     * @param file_path Path of the parsed file, used as reference for relative includes.
+     * @throws std::runtime_error If an included file cannot be read or parsed, or
+     *         includes form a cycle.
+     */
+    void resolveIncludes(const std::string& file_path);
+
     /**
      * @brief Emits the data node in YAML format.
      *
@@ -330,6 +510,16 @@ private:
      */
     std::string emitJson() const;
 
+    /**
+     * @brief Emits the data node as ordered chunks, in parallel if possible.
+     *
+     * @param format Format to emit the data node in.
+     * @param num_threads Number of threads to emit with (0: all threads of the shared pool).
+     * @returns Emitted chunks, whose concatenation is the serial emission.
+     * @throws std::runtime_error If the data node is invalid.
+     */
+    std::vector<std::string> emitChunks(Format format, size_t num_threads) const;
+
     /**
 	 * @brief Converts a csubstr buffer to a string.
 	 *
@@ -338,6 +528,9 @@ private:
 	 */
     std::string toStr(const c4::csubstr& buffer) const;
 
+    /// Minimum number of children of a node to emit it in parallel.
+    static constexpr size_t kMinParallelEmitChildren = 64;
+
     /// Tree structure of the data node.
     std::shared_ptr<ryml::Tree> tree_;
     /// ID of the data node within the tree.
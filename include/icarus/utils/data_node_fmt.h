@@ -0,0 +1,75 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/data_node_fmt.h
+ * @brief Definition of the fmt formatter of the class DataNode.
+ *
+ * Including this header allows passing data nodes directly to fmt and spdlog, e.g.,
+ * `logger->debug("Contract: {:jc}", node)`. The node is only emitted if the message is
+ * actually formatted, i.e., not for disabled log levels.
+ */
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "icarus/utils/data_node.h"
+
+/**
+ * @brief Formatter of data nodes emitting into the output buffer of fmt.
+ *
+ * Format specification: `[y|j][c][depth]`
+ * - `y` (default): YAML, `j`: JSON.
+ * - `c`: compact single-line output (flow style for YAML).
+ * - `depth`: number of nesting levels to emit; deeper containers are written as `{...}`.
+ *
+ * Without `c` and depth, the output equals DataNode::emitStr without the trailing newline.
+ *
+ * Examples: `{}`, `{:j}`, `{:c}`, `{:y2}`, `{:jc1}`.
+ * @ingroup StructuredData
+ */
+template<>
+struct fmt::formatter<icarus::DataNode> {
+    /// Options of the emission, parsed from the format specification.
+    icarus::DataNode::EmitOptions options;
+
+    constexpr auto parse(format_parse_context& ctx) -> decltype(ctx.begin()) {
+        auto it = ctx.begin();
+        auto end = ctx.end();
+        if (it != end && (*it == 'y' || *it == 'j')) {
+            options.format = (*it == 'j') ? icarus::DataNode::Format::kJson
+                                          : icarus::DataNode::Format::kYaml;
+            ++it;
+        }
+        if (it != end && *it == 'c') {
+            options.is_compact = true;
+            ++it;
+        }
+        if (it != end && *it >= '0' && *it <= '9') {
+            size_t depth = 0;
+            for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+                depth = depth * 10 + static_cast<size_t>(*it - '0');
+            }
+            options.max_depth = depth;
+        }
+        if (it != end && *it != '}') {
+            throw format_error("Invalid format specification of a DataNode");
+        }
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const icarus::DataNode& node, FormatContext& ctx) const -> decltype(ctx.out()) {
+        auto out = ctx.out();
+        if (!node.isValid()) {
+            return fmt::format_to(out, "<invalid>");
+        }
+        node.emitTo([&out](std::string_view piece) {
+            out = std::copy(piece.begin(), piece.end(), out);
+        }, options);
+        return out;
+    }
+};
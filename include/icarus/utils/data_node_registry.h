@@ -0,0 +1,114 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/data_node_registry.h
+ * @brief Definition of the class DataNodeRegistry.
+ */
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "icarus/utils/data_node.h"
+
+namespace icarus {
+
+/**
+ * @brief Process-wide registry aggregating the memory statistics of parsed data nodes.
+ *
+ * When enabled, every data node parsed from a file records its statistics under the
+ * path of the source file. The registry is disabled by default to avoid the cost of
+ * the additional tree traversal.
+ * @ingroup StructuredData
+ */
+class DataNodeRegistry {
+public:
+    /**
+     * @brief Aggregated statistics of all loads of one source file.
+     */
+    struct SourceStats {
+        size_t num_loads = 0;   ///< Number of times the source has been loaded.
+        DataNode::Stats last;   ///< Statistics of the last load.
+        DataNode::Stats peak;   ///< Maximum of each statistic over all loads.
+    };
+
+    /**
+     * @brief Returns the process-wide registry instance.
+     *
+     * @returns Reference to the registry.
+     */
+    static DataNodeRegistry& getInstance();
+
+    /**
+     * @brief Enables or disables the recording of statistics.
+     *
+     * @param is_enabled Flag to enable the recording.
+     */
+    void setEnabled(bool is_enabled);
+
+    /**
+     * @brief Returns whether the recording of statistics is enabled.
+     *
+     * @returns True if enabled, false otherwise.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Records the statistics of a load of a given source.
+     *
+     * @param source Name of the source, e.g., the path of the parsed file.
+     * @param stats Statistics of the loaded data node.
+     */
+    void record(const std::string& source, const DataNode::Stats& stats);
+
+    /**
+     * @brief Returns the aggregated statistics of a given source.
+     *
+     * @param source Name of the source.
+     * @returns Aggregated statistics (empty if the source has not been recorded).
+     */
+    SourceStats getSourceStats(const std::string& source) const;
+
+    /**
+     * @brief Returns the aggregated statistics of all recorded sources.
+     *
+     * @returns Map of source names to their aggregated statistics.
+     */
+    std::map<std::string, SourceStats> getAllStats() const;
+
+    /**
+     * @brief Returns the sum of the last statistics of all sources.
+     *
+     * Depths and widths are aggregated as maximum instead of sum.
+     *
+     * @returns Total statistics of all recorded sources.
+     */
+    DataNode::Stats getTotal() const;
+
+    /**
+     * @brief Builds a report of all recorded sources as data node (map).
+     *
+     * @returns Map with one child per source containing its last and peak statistics.
+     */
+    DataNode toDataNode() const;
+
+    /**
+     * @brief Removes all recorded statistics.
+     */
+    void clear();
+
+private:
+    DataNodeRegistry() = default;
+
+    /// Flag to enable the recording.
+    std::atomic<bool> is_enabled_{false};
+    /// Mutex protecting the recorded statistics.
+    mutable std::mutex mutex_;
+    /// Aggregated statistics per source.
+    std::map<std::string, SourceStats> sources_;
+};
+
+} // namespace icarus
@@ -0,0 +1,154 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/expression.h
+ * @brief Definition of the class Expression.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "icarus/utils/data_node.h"
+
+namespace icarus {
+
+/**
+ * @brief Compiled arithmetic/logic expression, e.g., an assumption or guarantee of a contract.
+ *
+ * The expression string is parsed once into a compact postfix bytecode. Identifiers
+ * (e.g., port names like `result` or `port.field`) are resolved to slot indices at
+ * compile time, so evaluating the expression only reads a value vector. All values are
+ * represented as `double`; boolean results are 1.0 (true) or 0.0 (false).
+ *
+ * Supported syntax (by increasing precedence):
+ * - `or`, `||`
+ * - `and`, `&&`
+ * - `not`, `!`
+ * - `==`, `!=`, `<`, `<=`, `>`, `>=`
+ * - `+`, `-`
+ * - `*`, `/`, `%`
+ * - unary `-`, `+`
+ * - numbers, `True`/`False` (or `true`/`false`), identifiers, parentheses,
+ *   and the functions `abs(x)`, `min(x, y)` and `max(x, y)`.
+ * @ingroup Expressions
+ */
+class Expression {
+public:
+    /**
+     * @brief Compiles an expression string.
+     *
+     * @param source Expression string, e.g., "result >= 0".
+     * @param slot_names Names of the identifiers; the position of a name is its slot index.
+     * @throws std::runtime_error If the expression has a syntax error or an unknown identifier.
+     */
+    Expression(const std::string& source, const std::vector<std::string>& slot_names);
+
+    /**
+     * @brief Compiles the scalar value of a data node, e.g., the node "guarantee" of a contract.
+     *
+     * @param node Data node containing the expression string.
+     * @param slot_names Names of the identifiers; the position of a name is its slot index.
+     * @throws std::runtime_error If the expression has a syntax error or an unknown identifier.
+     */
+    Expression(const DataNode& node, const std::vector<std::string>& slot_names);
+
+    /**
+     * @brief Evaluates the expression for one sample.
+     *
+     * @param values Pointer to the values of all slots of the sample.
+     * @returns Result of the expression.
+     */
+    double evaluate(const double* values) const;
+
+    /**
+     * @copydoc Expression::evaluate(const double*) const
+     */
+    double evaluate(const std::vector<double>& values) const;
+
+    /**
+     * @brief Evaluates the expression for one sample and interprets the result as boolean.
+     *
+     * @param values Values of all slots of the sample.
+     * @returns True if the result is non-zero, false otherwise.
+     */
+    bool isSatisfied(const std::vector<double>& values) const;
+
+    /**
+     * @brief Evaluates the expression for many samples at once.
+     *
+     * The samples are processed in blocks, each instruction being applied to a whole block
+     * in a tight loop that the compiler can vectorize.
+     *
+     * @param columns Pointers to the value arrays of all slots (one array per slot).
+     * @param num_samples Number of samples, i.e., length of each value array.
+     * @param results Output array of size num_samples.
+     */
+    void evaluateBatch(const double* const* columns, size_t num_samples, double* results) const;
+
+    /**
+     * @brief Evaluates the expression for many samples at once.
+     *
+     * @param columns Value arrays of all slots (one array per slot, all of equal length).
+     * @returns Results of the expression for all samples.
+     * @throws std::runtime_error If the number or the lengths of the columns are invalid.
+     */
+    std::vector<double> evaluateBatch(const std::vector<std::vector<double>>& columns) const;
+
+    /**
+     * @brief Returns the source string of the expression.
+     *
+     * @returns Expression string.
+     */
+    const std::string& getSource() const;
+
+    /**
+     * @brief Returns the sorted indices of the slots used by the expression.
+     *
+     * @returns Indices of the used slots.
+     */
+    std::vector<size_t> getUsedSlots() const;
+
+private:
+    /**
+     * @brief Operation code of a bytecode instruction.
+     */
+    enum class OpCode : uint8_t {
+        kConst, kLoad,
+        kNeg, kNot, kAbs,
+        kAdd, kSub, kMul, kDiv, kMod, kMin, kMax,
+        kEq, kNe, kLt, kLe, kGt, kGe,
+        kAnd, kOr
+    };
+
+    /**
+     * @brief Bytecode instruction with an optional argument (constant or slot index).
+     */
+    struct Instruction {
+        OpCode op;     ///< Operation code.
+        uint32_t arg;  ///< Index of the constant (kConst) or the slot (kLoad).
+    };
+
+    class Parser;
+
+    /// Maximum depth of the evaluation stack.
+    static constexpr size_t kMaxStackDepth = 64;
+    /// Number of samples processed per block during batch evaluation.
+    static constexpr size_t kBatchBlockSize = 256;
+
+    /// Source string of the expression.
+    std::string source_;
+    /// Number of slots the expression was compiled for.
+    size_t num_slots_ = 0;
+    /// Bytecode of the expression in postfix order.
+    std::vector<Instruction> code_;
+    /// Constant pool of the expression.
+    std::vector<double> constants_;
+    /// Maximum depth of the evaluation stack.
+    size_t max_stack_depth_ = 0;
+};
+
+} // namespace icarus
@@ -0,0 +1,274 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/feature_graph.h
+ * @brief Definition of the class FeatureGraph.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "icarus/utils/data_node.h"
+
+namespace icarus {
+
+/**
+ * @brief Compiled, indexed representation of a feature model.
+ *
+ * The graph is built in one pass over a feature model data node containing a `ROOT`
+ * feature name and a `FEATURES` sequence of single-key maps, each with a `type`
+ * (`mandatory`, `optional`, `XOR` or `OR`) and a `parent` name. Feature names are
+ * interned to dense IDs assigned in depth-first preorder, so that the subtree of a
+ * feature is a contiguous ID range. Children are stored in CSR form (one offsets
+ * array and one flat children array) and feature types as bitsets.
+ * @ingroup StructuredData
+ */
+class FeatureGraph {
+public:
+    /// Dense ID of a feature.
+    using FeatureId = uint32_t;
+
+    /// Invalid feature ID, e.g., parent of the root feature.
+    static constexpr FeatureId kInvalidId = UINT32_MAX;
+
+    /**
+     * @brief Type of a feature relative to its parent.
+     */
+    enum class FeatureType : uint8_t {
+        kRoot,       ///< Root feature of the model.
+        kMandatory,  ///< Mandatory child feature.
+        kOptional,   ///< Optional child feature.
+        kXor,        ///< Member of an alternative (exactly one) group.
+        kOr          ///< Member of an or (at least one) group.
+    };
+
+    /**
+     * @brief Contiguous range of child feature IDs.
+     */
+    struct ChildRange {
+        const FeatureId* first;  ///< Pointer to the first child ID.
+        const FeatureId* last;   ///< Pointer past the last child ID.
+
+        const FeatureId* begin() const { return first; }
+        const FeatureId* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    /**
+     * @brief Set of features, e.g., a configuration, stored as bitset.
+     */
+    class FeatureSet {
+    public:
+        /**
+         * @brief Constructs an empty feature set for a given number of features.
+         *
+         * @param num_features Number of features of the graph.
+         */
+        explicit FeatureSet(size_t num_features = 0);
+
+        /**
+         * @brief Adds a feature to the set.
+         *
+         * @param id ID of the feature to add.
+         * @throws std::runtime_error If the ID is out of range of the set.
+         */
+        void insert(FeatureId id);
+
+        /**
+         * @brief Removes a feature from the set.
+         *
+         * @param id ID of the feature to remove.
+         * @throws std::runtime_error If the ID is out of range of the set.
+         */
+        void erase(FeatureId id);
+
+        /**
+         * @brief Checks whether a feature is contained in the set.
+         *
+         * The ID is not checked, so it must be less than getNumFeatures().
+         *
+         * @param id ID of the feature to check.
+         * @returns True if the feature is contained, false otherwise.
+         */
+        bool contains(FeatureId id) const {
+            return (words_[id >> 6] >> (id & 63)) & 1u;
+        }
+
+        /**
+         * @brief Returns the number of features in the set.
+         *
+         * @returns Number of contained features.
+         */
+        size_t count() const;
+
+        /**
+         * @brief Returns the number of features the set was created for.
+         *
+         * @returns Number of features of the graph.
+         */
+        size_t getNumFeatures() const;
+
+    private:
+        /// Number of features the set was created for.
+        size_t num_features_;
+        /// Bits of the set (64 features per word).
+        std::vector<uint64_t> words_;
+    };
+
+    /**
+     * @brief Builds the feature graph from a feature model data node.
+     *
+     * @param fm_spec Data node (map) with the keys "ROOT" and "FEATURES".
+     * @throws std::runtime_error If the feature model is malformed, e.g., a feature is
+     *         defined twice, has an unknown type or is not reachable from the root.
+     */
+    explicit FeatureGraph(const DataNode& fm_spec);
+
+    /**
+     * @brief Returns the number of features, including the root.
+     *
+     * @returns Number of features.
+     */
+    size_t getNumFeatures() const;
+
+    /**
+     * @brief Returns the ID of the root feature.
+     *
+     * @returns ID of the root feature (always 0).
+     */
+    FeatureId getRootId() const;
+
+    /**
+     * @brief Finds a feature by name.
+     *
+     * @param name Name of the feature.
+     * @returns ID of the feature, or kInvalidId if no feature has the name.
+     */
+    FeatureId findFeature(const std::string& name) const;
+
+    /**
+     * @brief Returns the name of a feature.
+     *
+     * @param id ID of the feature.
+     * @returns Name of the feature.
+     */
+    const std::string& getName(FeatureId id) const;
+
+    /**
+     * @brief Returns the type of a feature.
+     *
+     * @param id ID of the feature.
+     * @returns Type of the feature.
+     */
+    FeatureType getType(FeatureId id) const;
+
+    /**
+     * @brief Checks whether a feature has a given type using the type bitsets.
+     *
+     * @param id ID of the feature.
+     * @param type Type to check for.
+     * @returns True if the feature has the type, false otherwise.
+     */
+    bool isOfType(FeatureId id, FeatureType type) const;
+
+    /**
+     * @brief Returns the parent of a feature.
+     *
+     * @param id ID of the feature.
+     * @returns ID of the parent feature, or kInvalidId for the root.
+     */
+    FeatureId getParent(FeatureId id) const;
+
+    /**
+     * @brief Returns the children of a feature.
+     *
+     * @param id ID of the feature.
+     * @returns Range of the child IDs (in definition order).
+     */
+    ChildRange getChildren(FeatureId id) const;
+
+    /**
+     * @brief Returns the children of a feature that have a given type, e.g., its XOR group.
+     *
+     * @param id ID of the parent feature.
+     * @param type Type of the group members.
+     * @returns IDs of the group members.
+     */
+    std::vector<FeatureId> getGroup(FeatureId id, FeatureType type) const;
+
+    /**
+     * @brief Returns the depth of a feature (0 for the root).
+     *
+     * @param id ID of the feature.
+     * @returns Depth of the feature.
+     */
+    size_t getDepth(FeatureId id) const;
+
+    /**
+     * @brief Checks in constant time whether a feature is an ancestor of another one.
+     *
+     * @param ancestor ID of the potential ancestor.
+     * @param descendant ID of the potential descendant.
+     * @returns True if ancestor is a proper ancestor of descendant, false otherwise.
+     */
+    bool isAncestor(FeatureId ancestor, FeatureId descendant) const;
+
+    /**
+     * @brief Creates a feature set from feature names.
+     *
+     * @param names Names of the features to include.
+     * @returns Feature set with the named features.
+     * @throws std::runtime_error If a name is not a feature of the graph.
+     */
+    FeatureSet makeFeatureSet(const std::vector<std::string>& names) const;
+
+    /**
+     * @brief Validates a configuration in time linear in the number of features.
+     *
+     * A configuration is valid if it contains the root, the parent of each selected
+     * feature, all mandatory children of selected features, exactly one member of each
+     * XOR group and at least one member of each OR group of selected features.
+     *
+     * @param config Selected features.
+     * @returns Descriptions of all violations (empty if the configuration is valid).
+     * @throws std::runtime_error If the set was not created for the number of features of the graph.
+     */
+    std::vector<std::string> validateConfiguration(const FeatureSet& config) const;
+
+    /**
+     * @brief Returns whether a configuration is valid.
+     *
+     * @param config Selected features.
+     * @returns True if the configuration is valid, false otherwise.
+     * @throws std::runtime_error If the set was not created for the number of features of the graph.
+     */
+    bool isValidConfiguration(const FeatureSet& config) const;
+
+private:
+    /// Names of the features (indexed by ID).
+    std::vector<std::string> names_;
+    /// Lookup table of feature names to IDs.
+    std::unordered_map<std::string, FeatureId> ids_;
+    /// Types of the features (indexed by ID).
+    std::vector<FeatureType> types_;
+    /// One bitset of feature IDs per feature type.
+    std::vector<FeatureSet> type_sets_;
+    /// Parents of the features (indexed by ID).
+    std::vector<FeatureId> parents_;
+    /// Depths of the features (indexed by ID).
+    std::vector<uint32_t> depths_;
+    /// End of the preorder ID range of the subtree of each feature (exclusive).
+    std::vector<FeatureId> subtree_ends_;
+    /// CSR offsets of the children of each feature into children_ (size: features + 1).
+    std::vector<uint32_t> child_offsets_;
+    /// Children of all features, grouped by parent.
+    std::vector<FeatureId> children_;
+};
+
+} // namespace icarus
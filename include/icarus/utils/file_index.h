@@ -0,0 +1,139 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/file_index.h
+ * @brief Definition of the class FileIndex.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace icarus::utils {
+
+/**
+ * @brief In-memory index of the entries of a directory tree, e.g., a workspace.
+ *
+ * The tree is scanned once in parallel on the I/O thread pool, recording the type, size and
+ * modification time of each entry from a single stat call (on Linux, readdir and fstatat
+ * relative to the open directory). Queries about existence, types, extensions and relative
+ * paths are then answered from memory without any system call. Symbolic links are
+ * indexed with the type of their target but not followed into directories. Unreadable
+ * directories are skipped.
+ * @ingroup SystemOps
+ */
+class FileIndex {
+public:
+    /**
+     * @brief Type of an indexed entry.
+     */
+    enum class EntryType : uint8_t {
+        kFile,       ///< Regular file.
+        kDirectory,  ///< Directory.
+        kOther       ///< Other entry, e.g., a socket or a dangling link.
+    };
+
+    /**
+     * @brief Indexed entry of the tree.
+     */
+    struct Entry {
+        std::filesystem::path path;              ///< Absolute, normalized path.
+        EntryType type = EntryType::kOther;      ///< Type of the entry.
+        uintmax_t size = 0;                      ///< Size in bytes (files only).
+        std::filesystem::file_time_type mtime;   ///< Time of the last modification.
+    };
+
+    /**
+     * @brief Scans a directory tree.
+     *
+     * The scan runs on the I/O thread pool, so the index must not be built from one of its
+     * tasks.
+     *
+     * @param root_dir Root directory of the tree (relative to the working directory or absolute).
+     * @throws std::runtime_error If the root is not a directory.
+     */
+    explicit FileIndex(const std::filesystem::path& root_dir);
+
+    /**
+     * @brief Scans the tree again, replacing the indexed entries.
+     *
+     * @throws std::runtime_error If the root is not a directory anymore.
+     * @throws Exception of a failed scan task (e.g., std::bad_alloc), after all tasks ended.
+     */
+    void rescan();
+
+    /**
+     * @brief Returns the root directory of the tree.
+     *
+     * @returns Absolute, normalized root directory.
+     */
+    const std::filesystem::path& getRootDir() const;
+
+    /**
+     * @brief Returns all indexed entries, ordered by path (without the root itself).
+     *
+     * @returns Reference to the entries.
+     */
+    const std::vector<Entry>& getEntries() const;
+
+    /**
+     * @brief Looks up an entry.
+     *
+     * @param path Path of the entry (relative to the root directory or absolute).
+     * @returns Pointer to the entry, nullptr if the path is not indexed.
+     */
+    const Entry* find(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Checks whether a path is an indexed regular file with a given extension.
+     *
+     * Equivalent to utils::isValidFile, but answered from the index and without output.
+     *
+     * @param file_path Path of the file (relative to the root directory or absolute).
+     * @param extension Extension without dot, e.g., "yaml".
+     * @returns True if the file is indexed and has the extension, false otherwise.
+     */
+    bool isValidFile(const std::filesystem::path& file_path, const std::string& extension) const;
+
+    /**
+     * @brief Returns all files with a given extension.
+     *
+     * @param extension Extension without dot, e.g., "yaml".
+     * @returns Entries of the files, ordered by path.
+     */
+    std::vector<const Entry*> getFilesWithExtension(const std::string& extension) const;
+
+    /**
+     * @brief Resolves a target path against a directory and looks it up, like utils::getAbsPath.
+     *
+     * @param dir_path Directory used as reference for a relative target path (relative
+     *        directories are relative to the root directory).
+     * @param target_path Target path (relative to the directory or absolute).
+     * @returns Pointer to the entry of the target, nullptr if it is not indexed.
+     */
+    const Entry* resolve(const std::filesystem::path& dir_path, const std::string& target_path) const;
+
+private:
+    /**
+     * @brief Returns the lookup key of a path.
+     *
+     * @param path Path relative to the root directory or absolute.
+     * @returns Absolute, normalized path without trailing separator.
+     */
+    std::string getKey(const std::filesystem::path& path) const;
+
+    /// Absolute, normalized root directory.
+    std::filesystem::path root_dir_;
+    /// Entries ordered by path.
+    std::vector<Entry> entries_;
+    /// Index of each entry by its path.
+    std::unordered_map<std::string, size_t> entry_ids_;
+    /// Indices of the files by extension (without dot).
+    std::unordered_map<std::string, std::vector<size_t>> extension_ids_;
+};
+
+} // namespace icarus::utils
@@ -0,0 +1,178 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/indented_writer.h
+ * @brief Definition of the class IndentedWriter.
+ */
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace icarus::utils {
+
+/**
+ * @brief Buffered text writer which indents every line by a stack of indentation levels.
+ *
+ * Text is collected in one reusable buffer and passed to the sink only when the buffer is
+ * full, on flush() or on destruction. A full buffer passes only its complete lines and keeps
+ * the unterminated rest (growing beyond its capacity for longer lines), so that a line is
+ * never split between two sink calls. Line starts are found with memchr, and the current
+ * indentation prefix is kept as one string, so that indenting costs one copy per line.
+ * @ingroup StringProcessing
+ */
+class IndentedWriter {
+public:
+    /// Callback receiving the buffered text.
+    using Sink = std::function<void(std::string_view)>;
+
+    /// Default capacity of the buffer in bytes.
+    static constexpr size_t kDefaultBufferSize = 16 * 1024;
+
+    /**
+     * @brief Creates a writer passing its output to a sink.
+     *
+     * @param sink Callback receiving the buffered text.
+     * @param buffer_size [opt] Capacity of the buffer in bytes.
+     */
+    explicit IndentedWriter(Sink sink, size_t buffer_size = kDefaultBufferSize);
+
+    /**
+     * @brief Flushes the remaining text to the sink.
+     */
+    ~IndentedWriter();
+
+    IndentedWriter(IndentedWriter&&) = default;
+    IndentedWriter& operator=(IndentedWriter&&) = delete;
+    IndentedWriter(const IndentedWriter&) = delete;
+    IndentedWriter& operator=(const IndentedWriter&) = delete;
+
+    /**
+     * @brief Creates a writer to a C file stream, e.g., stdout.
+     *
+     * @param file Open file stream (not closed by the writer).
+     * @returns Writer to the file.
+     */
+    static IndentedWriter toFile(std::FILE* file);
+
+    /**
+     * @brief Creates a writer appending to a string.
+     *
+     * @param str String to append to; must outlive the writer.
+     * @returns Writer to the string.
+     */
+    static IndentedWriter toString(std::string& str);
+
+    /**
+     * @brief Creates a writer logging each line as one message.
+     *
+     * Lines not terminated when the writer is flushed are logged as they are.
+     *
+     * @param logger Logger to log to.
+     * @param level [opt] Level of the log messages.
+     * @returns Writer to the logger.
+     */
+    static IndentedWriter toLogger(std::shared_ptr<spdlog::logger> logger,
+                                   spdlog::level::level_enum level = spdlog::level::info);
+
+    /**
+     * @brief Adds an indentation level, applied from the next line start on.
+     *
+     * @param indent Indentation string of the level, e.g., "  " or "- ".
+     * @param is_hanging [opt] Flag to use the string only for the first line and blanks
+     *        of the same width for the following lines (like list items).
+     */
+    void pushIndent(std::string_view indent, bool is_hanging = false);
+
+    /**
+     * @brief Adds an indentation level of spaces.
+     *
+     * @param num_spaces [opt] Number of spaces.
+     */
+    void pushIndent(size_t num_spaces = 4);
+
+    /**
+     * @brief Removes the innermost indentation level.
+     *
+     * @throws std::runtime_error If there is no indentation level.
+     */
+    void popIndent();
+
+    /**
+     * @brief Returns the number of indentation levels.
+     *
+     * @returns Number of indentation levels.
+     */
+    size_t getIndentLevel() const;
+
+    /**
+     * @brief Writes text, indenting each line start.
+     *
+     * @param text Text to write (possibly with multiple lines).
+     */
+    void write(std::string_view text);
+
+    /**
+     * @brief Writes text followed by a line end.
+     *
+     * @param text Text to write.
+     */
+    void writeLine(std::string_view text = {});
+
+    /**
+     * @brief Writes text without indentation.
+     *
+     * @param text Text to write.
+     */
+    void writeRaw(std::string_view text);
+
+    /**
+     * @brief Passes the buffered text to the sink.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief Indentation level within the prefix.
+     */
+    struct Level {
+        size_t offset;    ///< Offset of the level in the prefix.
+        bool is_hanging;  ///< Flag whether the level text is still to be blanked.
+    };
+
+    /**
+     * @brief Appends text to the buffer, passing its complete lines to the sink if full.
+     *
+     * @param text Text to append.
+     */
+    void append(std::string_view text);
+
+    /**
+     * @brief Replaces pending hanging indentation levels by blanks after a line end.
+     */
+    void endLine();
+
+    /// Sink receiving the buffered text.
+    Sink sink_;
+    /// Buffer of the text.
+    std::string buffer_;
+    /// Capacity of the buffer.
+    size_t buffer_size_;
+    /// Concatenated indentation of all levels.
+    std::string prefix_;
+    /// Indentation levels.
+    std::vector<Level> levels_;
+    /// Flag whether hanging levels wait for the end of their first line.
+    bool has_hanging_ = false;
+    /// Flag whether the next character starts a new line.
+    bool is_line_start_ = true;
+};
+
+} // namespace icarus::utils
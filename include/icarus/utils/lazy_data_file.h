@@ -0,0 +1,182 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/lazy_data_file.h
+ * @brief Definition of the class LazyDataFile.
+ */
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "icarus/utils/data_node.h"
+#include "icarus/utils/mapped_file.h"
+
+namespace icarus {
+
+/**
+ * @brief YAML file whose documents and top-level sections are parsed on first access.
+ *
+ * On construction, the file is mapped into memory and prescanned for the boundaries of
+ * its `---` documents and of the top-level keys of each document, without parsing it.
+ * Each section (top-level key with its value) is then parsed into a DataNode only when
+ * it is accessed for the first time, and cached afterwards.
+ *
+ * Documents whose root is not a block map, which use aliases (anchors might be
+ * defined in another section) or which have directives (e.g., %TAG handles used by
+ * all sections), are parsed as a whole on first access instead.
+ * Accesses are thread-safe.
+ * @ingroup StructuredData
+ */
+class LazyDataFile {
+public:
+    /**
+     * @brief Opens a YAML file and indexes its documents and top-level keys.
+     *
+     * @param file_path Path of the YAML file.
+     * @throws std::runtime_error If the file cannot be read.
+     */
+    explicit LazyDataFile(const std::string& file_path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~LazyDataFile();
+
+    LazyDataFile(const LazyDataFile&) = delete;
+    LazyDataFile& operator=(const LazyDataFile&) = delete;
+
+    /**
+     * @brief Returns the path of the file.
+     *
+     * @returns Path of the file.
+     */
+    const std::string& getFilePath() const;
+
+    /**
+     * @brief Returns the number of documents in the file.
+     *
+     * @returns Number of documents (at least 1).
+     */
+    size_t getNumDocuments() const;
+
+    /**
+     * @brief Returns the top-level keys of a document found by the prescan.
+     *
+     * @param doc_index [opt] Index of the document.
+     * @returns Keys in order of appearance (empty if the document is not sectioned).
+     * @throws std::runtime_error If the document index is out of range.
+     */
+    std::vector<std::string> getKeys(size_t doc_index = 0) const;
+
+    /**
+     * @brief Checks whether a document has a given top-level key.
+     *
+     * @param key Top-level key to check.
+     * @param doc_index [opt] Index of the document.
+     * @returns True if the key exists, false otherwise.
+     * @throws std::runtime_error If the document index is out of range or the document
+     *         cannot be parsed (only for documents which are not sectioned).
+     */
+    bool hasKey(const std::string& key, size_t doc_index = 0);
+
+    /**
+     * @brief Returns the value of a top-level key, parsing only its section if needed.
+     *
+     * @param key Top-level key.
+     * @param doc_index [opt] Index of the document.
+     * @returns Data node of the value of the key.
+     * @throws std::runtime_error If the key does not exist, the document index is out of
+     *         range or the section cannot be parsed.
+     */
+    DataNode get(const std::string& key, size_t doc_index = 0);
+
+    /**
+     * @brief Returns a whole document, parsing it if needed.
+     *
+     * @param doc_index [opt] Index of the document.
+     * @returns Root data node of the document.
+     * @throws std::runtime_error If the document index is out of range or the document
+     *         cannot be parsed.
+     */
+    DataNode getDocument(size_t doc_index = 0);
+
+    /**
+     * @brief Returns the number of sections and documents parsed so far.
+     *
+     * @returns Number of parsed sections and whole documents.
+     */
+    size_t getNumParsed() const;
+
+private:
+    /**
+     * @brief Byte range of a top-level key and its value.
+     */
+    struct Section {
+        std::string key;                ///< Top-level key.
+        size_t begin = 0;               ///< Offset of the first byte of the key line.
+        size_t end = 0;                 ///< Offset past the last byte of the value.
+        std::optional<DataNode> node;   ///< Parsed value, once accessed.
+    };
+
+    /**
+     * @brief Byte range of a document and its sections.
+     */
+    struct Document {
+        size_t begin = 0;                    ///< Offset of the first byte of the content.
+        size_t end = 0;                      ///< Offset past the last byte of the content.
+        bool is_sectioned = true;            ///< Flag whether sections can be parsed separately.
+        std::vector<Section> sections;       ///< Top-level sections in order.
+        std::unordered_map<std::string, size_t> section_ids;  ///< Index of each key in sections.
+        std::optional<DataNode> node;        ///< Parsed document, once accessed.
+    };
+
+    /**
+     * @brief Prescans the content for document and top-level key boundaries.
+     */
+    void buildIndex();
+
+    /**
+     * @brief Returns a document by index.
+     *
+     * @param doc_index Index of the document.
+     * @returns Reference to the document.
+     * @throws std::runtime_error If the document index is out of range.
+     */
+    const Document& getDocumentIndex(size_t doc_index) const;
+
+    /**
+     * @brief Parses a byte range of the file into a new tree.
+     *
+     * @param begin Offset of the first byte.
+     * @param end Offset past the last byte.
+     * @returns Root data node of the parsed range.
+     * @throws std::runtime_error If the range cannot be parsed.
+     */
+    DataNode parseRange(size_t begin, size_t end) const;
+
+    /**
+     * @brief Returns a document, parsing it if needed (mutex must be held).
+     *
+     * @param document Document to get.
+     * @returns Root data node of the document.
+     */
+    DataNode getParsedDocument(Document& document);
+
+    /// Path of the file.
+    std::string file_path_;
+    /// Content of the file.
+    utils::MappedFile content_;
+    /// Documents of the file in order.
+    std::vector<Document> documents_;
+    /// Number of parsed sections and documents.
+    size_t num_parsed_ = 0;
+    /// Mutex protecting the parsed nodes.
+    mutable std::mutex mutex_;
+};
+
+} // namespace icarus
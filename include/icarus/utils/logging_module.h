@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -14,6 +15,43 @@
 
 namespace icarus {
 
+class BinaryLogger;
+
+/**
+ * @brief Mode of the loggers created by logging modules.
+ *
+ * @ingroup Logging
+ */
+enum class LogMode {
+	kSync,  ///< Messages are written to the sink by the logging thread.
+	kAsync  ///< Messages are queued and written by the shared logging thread pool.
+};
+
+/**
+ * @brief Behavior of asynchronous loggers when the message queue is full.
+ *
+ * @ingroup Logging
+ */
+enum class OverflowPolicy {
+	kBlock,       ///< Wait for free space in the queue (no message is lost).
+	kDropOldest,  ///< Overwrite the oldest queued message.
+	kDropNewest   ///< Discard the new message (requires spdlog 1.13 or newer).
+};
+
+/**
+ * @brief Configuration of the thread pool shared by all asynchronous loggers.
+ *
+ * @ingroup Logging
+ */
+struct AsyncLogConfig {
+	/// Maximum number of queued messages.
+	size_t queue_size = 8192;
+	/// Number of threads writing the queued messages (1 keeps the order of the messages).
+	size_t num_threads = 1;
+	/// Behavior when the queue is full.
+	OverflowPolicy overflow_policy = OverflowPolicy::kBlock;
+};
+
 /**
  * @brief Module of the ICARUS environment with logging capabilities.
  * 
@@ -29,6 +67,18 @@ public:
 	 */
 	LoggingModule(const std::string& logger_name, bool is_colored = true);
 
+	/**
+	 * @brief Creates a logging module with a given configuration and log mode.
+	 *
+	 * Asynchronous loggers only format the message in the calling thread and leave writing
+	 * it to the shared thread pool, which is created with the current AsyncLogConfig if needed.
+	 *
+	 * @param logger_name Name of the logger.
+	 * @param is_colored Flag to enable colored output.
+	 * @param mode Mode of the logger.
+	 */
+	LoggingModule(const std::string& logger_name, bool is_colored, LogMode mode);
+
 	/**
 	 * @brief Creates a logging module from an existing logger.
 	 * 
@@ -44,9 +94,9 @@ public:
 	/**
 	 * @brief Returns the logger of the module.
 	 * 
-	 * @returns Shared pointer to the logger of the module.
+	 * @returns Reference to the shared pointer to the logger of the module.
 	 */
-	std::shared_ptr<spdlog::logger> getLogger() const;
+	const std::shared_ptr<spdlog::logger>& getLogger() const;
 
 	/**
 	 * @brief Returns the name of the logger.
@@ -62,6 +112,20 @@ public:
 	 */
 	void setLogger(std::shared_ptr<spdlog::logger> logger);
 
+	/**
+	 * @brief Returns the binary logger of the module, used by the ICARUS_BLOG_* macros.
+	 *
+	 * @returns Reference to the shared pointer to the binary logger (nullptr if not set).
+	 */
+	const std::shared_ptr<BinaryLogger>& getBinaryLogger() const;
+
+	/**
+	 * @brief Sets the binary logger of the module.
+	 *
+	 * @param binary_logger Binary logger to be set as shared pointer (may be shared by modules).
+	 */
+	void setBinaryLogger(std::shared_ptr<BinaryLogger> binary_logger);
+
 	/**
 	 * @brief Sets the log level of all loggers in the running program.
 	 * 
@@ -69,9 +133,126 @@ public:
 	 */
 	static void setGlobalLogLevel(spdlog::level::level_enum level);
 
+	/**
+	 * @brief Sets the mode of the loggers created afterwards without an explicit mode.
+	 *
+	 * @param mode Default log mode (initially LogMode::kSync).
+	 */
+	static void setDefaultLogMode(LogMode mode);
+
+	/**
+	 * @brief Returns the mode of the loggers created without an explicit mode.
+	 *
+	 * @returns Default log mode.
+	 */
+	static LogMode getDefaultLogMode();
+
+	/**
+	 * @brief Configures the thread pool shared by the asynchronous loggers and (re)creates it.
+	 *
+	 * Asynchronous loggers stay bound to the pool they were created with. A replaced pool
+	 * is therefore kept alive until all asynchronous loggers created with it by
+	 * LoggingModule are destroyed; only new loggers use the new configuration.
+	 *
+	 * @param config Configuration of the pool.
+	 * @throws std::runtime_error If the configuration is invalid or the overflow policy is
+	 *         not supported by the spdlog version.
+	 */
+	static void setAsyncConfig(const AsyncLogConfig& config);
+
+	/**
+	 * @brief Returns the configuration of the thread pool of the asynchronous loggers.
+	 *
+	 * @returns Configuration of the pool.
+	 */
+	static AsyncLogConfig getAsyncConfig();
+
+	/**
+	 * @brief Returns the number of messages dropped by the asynchronous loggers.
+	 *
+	 * Messages are only dropped with the overflow policies kDropOldest and kDropNewest. The
+	 * counter covers the lifetime of the current thread pool.
+	 *
+	 * @returns Number of dropped messages.
+	 */
+	static size_t getNumDroppedMessages();
+
 protected:
 	/// spdlog logger of the module.
 	std::shared_ptr<spdlog::logger> logger_ = nullptr;
+	/// Binary logger of the module.
+	std::shared_ptr<BinaryLogger> binary_logger_ = nullptr;
 };
 
-} // namespace icarus
\ No newline at end of file
+} // namespace icarus
+
+/**
+ * @defgroup LogMacros Logging macros
+ * @ingroup Logging
+ * @brief Macros logging to the logger of a LoggingModule.
+ *
+ * The level of the logger is checked (one atomic load) before the arguments are evaluated,
+ * so that filtered messages cost neither formatting nor the computation of their arguments.
+ * Levels below ICARUS_LOG_ACTIVE_LEVEL (an SPDLOG_LEVEL_* value, set with the CMake cache
+ * variable of the same name) are removed at compile time together with their arguments.
+ * @{
+ */
+
+#ifndef ICARUS_LOG_ACTIVE_LEVEL
+	/// Minimum level of the log statements that are compiled.
+	#define ICARUS_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/**
+ * @brief Logs a message to the logger of a logging module if the level is enabled.
+ *
+ * @param module Logging module (object or reference, e.g., `*this`).
+ * @param log_level spdlog level of the message.
+ * @param ... Format string and its arguments, only evaluated if the level is enabled.
+ */
+#define ICARUS_LOG(module, log_level, ...)                                                    \
+	do {                                                                                      \
+		spdlog::logger* icarus_log_logger_ = (module).getLogger().get();                      \
+		if (icarus_log_logger_ != nullptr && icarus_log_logger_->should_log(log_level)) {     \
+			icarus_log_logger_->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},  \
+			                        log_level, __VA_ARGS__);                                  \
+		}                                                                                     \
+	} while (0)
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+	#define ICARUS_LOG_TRACE(module, ...) ICARUS_LOG(module, spdlog::level::trace, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_TRACE(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+	#define ICARUS_LOG_DEBUG(module, ...) ICARUS_LOG(module, spdlog::level::debug, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_DEBUG(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+	#define ICARUS_LOG_INFO(module, ...) ICARUS_LOG(module, spdlog::level::info, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_INFO(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+	#define ICARUS_LOG_WARN(module, ...) ICARUS_LOG(module, spdlog::level::warn, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_WARN(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+	#define ICARUS_LOG_ERROR(module, ...) ICARUS_LOG(module, spdlog::level::err, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_ERROR(module, ...) (void)0
+#endif
+
+#if ICARUS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+	#define ICARUS_LOG_CRITICAL(module, ...) ICARUS_LOG(module, spdlog::level::critical, __VA_ARGS__)
+#else
+	#define ICARUS_LOG_CRITICAL(module, ...) (void)0
+#endif
+
+/// @}
@@ -0,0 +1,107 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/mapped_file.h
+ * @brief Definition of the class MappedFile.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace icarus::utils {
+
+/**
+ * @brief Read-only view of a file mapped into memory.
+ *
+ * The file is mapped with mmap on Linux and MapViewOfFile on Windows, and unmapped on
+ * destruction. Where mapping is not possible (e.g., empty files, pipes, procfs files or
+ * other platforms), the content is read into a buffer owned by the object instead, so
+ * that getView() works in all cases.
+ * @ingroup SystemOps
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Expected access pattern, passed to the kernel as a paging hint.
+     */
+    enum class AccessHint {
+        kNormal,      ///< No hint.
+        kSequential,  ///< Read from start to end: aggressive read-ahead.
+        kRandom       ///< Scattered access: no read-ahead.
+    };
+
+    /**
+     * @brief Maps a file into memory.
+     *
+     * @param file_path Path of the file to map.
+     * @param hint [opt] Expected access pattern.
+     * @param prefetch [opt] Flag to start reading the whole file into the page cache.
+     * @throws std::runtime_error If the file cannot be opened or read.
+     */
+    explicit MappedFile(const std::string& file_path, AccessHint hint = AccessHint::kSequential,
+                        bool prefetch = false);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns the content of the file.
+     *
+     * @returns View of the content, valid as long as the object exists.
+     */
+    std::string_view getView() const { return {data_, size_}; }
+
+    /**
+     * @brief Returns the first byte of the content.
+     *
+     * @returns Pointer to the content.
+     */
+    const char* data() const { return data_; }
+
+    /**
+     * @brief Returns the size of the content.
+     *
+     * @returns Size of the content in bytes.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Checks whether the file is empty.
+     *
+     * @returns True if the content is empty, false otherwise.
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Checks whether the content is mapped or was read into a buffer.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    bool isMapped() const { return mapping_ != nullptr; }
+
+private:
+    /**
+     * @brief Unmaps the file, if mapped.
+     */
+    void unmap();
+
+    /// First byte of the content.
+    const char* data_ = "";
+    /// Size of the content in bytes.
+    size_t size_ = 0;
+    /// Address of the mapping, if mapped.
+    void* mapping_ = nullptr;
+    /// Read content, if not mapped.
+    std::string buffer_;
+};
+
+} // namespace icarus::utils
@@ -0,0 +1,192 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/process.h
+ * @brief Declaration of functions for running child processes.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace icarus::utils {
+
+/// @addtogroup SystemOps
+/// @{
+
+/**
+ * @brief Handling of an output stream (stdout or stderr) of a child process.
+ */
+enum class StreamMode {
+    kCapture,  ///< Read the stream into the process result.
+    kInherit,  ///< Write to the stream of the calling process.
+    kDiscard   ///< Redirect the stream to the null device.
+};
+
+/**
+ * @brief Options of running a child process.
+ */
+struct ProcessOptions {
+    /// Data written to stdin before it is closed (std::nullopt: inherit stdin).
+    std::optional<std::string> stdin_data;
+    /// Handling of stdout.
+    StreamMode stdout_mode = StreamMode::kCapture;
+    /// Handling of stderr.
+    StreamMode stderr_mode = StreamMode::kCapture;
+    /// Time after which the process is killed (zero: no timeout).
+    std::chrono::milliseconds timeout{0};
+    /// Receives captured stdout in chunks instead of collecting it in the result.
+    std::function<void(std::string_view)> stdout_sink;
+    /// Flag to kill the process once set, checked periodically (nullptr: not cancellable).
+    const std::atomic<bool>* cancel_flag = nullptr;
+};
+
+/**
+ * @brief Result of a finished child process.
+ */
+struct ProcessResult {
+    int exit_code = -1;          ///< Exit code, -1 if the process was terminated by a signal.
+    int signal = 0;              ///< Signal that terminated the process, 0 if it exited.
+    bool is_timed_out = false;   ///< Flag whether the process was killed after the timeout.
+    bool is_cancelled = false;   ///< Flag whether the process was cancelled.
+    std::string stdout_data;     ///< Captured stdout.
+    std::string stderr_data;     ///< Captured stderr.
+    std::chrono::microseconds wall_time{0};  ///< Elapsed time from start to exit.
+    std::chrono::microseconds cpu_time{0};   ///< User and system CPU time of the process.
+};
+
+/**
+ * @brief Runs a program as a child process and waits for it to finish.
+ *
+ * The program is started with posix_spawn without a shell, so the arguments are passed
+ * as they are. The program is searched in PATH if it contains no slash. Captured streams
+ * and stdin are served concurrently with poll, so that the child never blocks on a full
+ * pipe, and the timeout is enforced with SIGKILL.
+ *
+ * @param argv Program and its arguments.
+ * @param options [opt] Options of the process.
+ * @returns Result of the process.
+ * @throws std::runtime_error If argv is empty or the process could not be started.
+ */
+ProcessResult runProcess(const std::vector<std::string>& argv, const ProcessOptions& options = {});
+
+/**
+ * @brief Runs a program as a child process on its own thread.
+ *
+ * @param argv Program and its arguments.
+ * @param options [opt] Options of the process.
+ * @returns Future of the result of the process (holding the errors of runProcess).
+ */
+std::future<ProcessResult> runProcessAsync(std::vector<std::string> argv,
+                                           ProcessOptions options = {});
+
+/**
+ * @brief Pool running queued processes with a bounded number of concurrent jobs.
+ *
+ * Each job slot is a worker thread running one process at a time with runProcess(), so
+ * that batches of tool invocations use all cores without overloading the machine. Queued
+ * jobs are started in FIFO order.
+ */
+class ProcessPool {
+public:
+    /**
+     * @brief Creates a pool and starts its job slots.
+     *
+     * @param max_jobs [opt] Maximum number of concurrent processes (0: getDefaultNumJobs()).
+     */
+    explicit ProcessPool(size_t max_jobs = 0);
+
+    /**
+     * @brief Waits for all queued and running jobs and stops the job slots.
+     */
+    ~ProcessPool();
+
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+
+    /**
+     * @brief Returns the default number of concurrent jobs.
+     *
+     * The job limit of a calling make (`-jN` or `--jobs=N` in MAKEFLAGS) is used if set,
+     * the number of hardware threads otherwise. The make job server itself is not used.
+     *
+     * @returns Number of concurrent jobs.
+     */
+    static size_t getDefaultNumJobs();
+
+    /**
+     * @brief Queues a process.
+     *
+     * @param argv Program and its arguments.
+     * @param options [opt] Options of the process (the cancellation flag is set by the pool).
+     * @returns Future of the result of the process (holding the errors of runProcess).
+     */
+    std::future<ProcessResult> submit(std::vector<std::string> argv, ProcessOptions options = {});
+
+    /**
+     * @brief Cancels all jobs: queued jobs are not started and running processes are killed.
+     *
+     * The results of cancelled jobs are flagged with is_cancelled. The function returns
+     * after all running processes were stopped; the pool accepts new jobs afterwards.
+     */
+    void cancel();
+
+    /**
+     * @brief Waits until all queued and running jobs are finished.
+     */
+    void wait();
+
+    /**
+     * @brief Returns the maximum number of concurrent processes.
+     *
+     * @returns Number of job slots.
+     */
+    size_t getMaxJobs() const;
+
+private:
+    /**
+     * @brief Queued process with the promise of its result.
+     */
+    struct Job {
+        std::vector<std::string> argv;          ///< Program and its arguments.
+        ProcessOptions options;                 ///< Options of the process.
+        std::promise<ProcessResult> promise;    ///< Promise of the result.
+    };
+
+    /**
+     * @brief Loop of a job slot running queued jobs until the pool is stopped.
+     */
+    void run();
+
+    /// Job slots.
+    std::vector<std::thread> workers_;
+    /// Queued jobs.
+    std::queue<Job> jobs_;
+    /// Number of running jobs.
+    size_t num_running_ = 0;
+    /// Mutex protecting the queue, the counter and the stop flag.
+    std::mutex mutex_;
+    /// Condition variable signaling new jobs or stopping.
+    std::condition_variable cv_;
+    /// Condition variable signaling finished jobs.
+    std::condition_variable done_cv_;
+    /// Flag to kill the running processes.
+    std::atomic<bool> is_cancelling_{false};
+    /// Flag to stop the job slots once the queue is empty.
+    bool is_stopping_ = false;
+};
+
+/// @}
+
+} // namespace icarus::utils
@@ -0,0 +1,157 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/schema.h
+ * @brief Definition of the class Schema.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "icarus/utils/data_node.h"
+
+namespace icarus {
+
+/**
+ * @brief Compiled schema for validating YAML/JSON data nodes.
+ *
+ * A schema is itself specified in YAML and compiled once into a flat list of rules.
+ * Validating a document then checks all rules in a single traversal of the document
+ * and reports every violation with its path. A schema node supports the keys:
+ * - `type`: `any` (default), `map`, `seq`, `scalar`, `str`, `int`, `float`, `bool` or `null`.
+ * - `nullable`: Allows a null value (`~`, `null` or empty) in addition to the type.
+ * - `required`: Sequence of keys that a map must contain.
+ * - `properties`: Map of keys to the schemas of the corresponding map values.
+ * - `values`: Schema of all map values whose keys are not listed in `properties`.
+ * - `additional`: Whether keys not listed in `properties` are allowed (default: true).
+ * - `items`: Schema of all sequence items.
+ * - `min_size`/`max_size`: Bounds of the number of children of a map or sequence.
+ * - `enum`: Sequence of the allowed scalar values.
+ *
+ * Example (PORTS section of a contract file):
+ * @code{.yaml}
+ * type: map
+ * required: [PORTS]
+ * properties:
+ *   PORTS:
+ *     type: seq
+ *     items:
+ *       type: map
+ *       min_size: 1
+ *       max_size: 1
+ *       values:
+ *         type: map
+ *         required: [direction, interface]
+ *         properties:
+ *           direction: { type: str, enum: [input, output] }
+ * @endcode
+ * @ingroup StructuredData
+ */
+class Schema {
+public:
+    /**
+     * @brief Violation of a schema found during validation.
+     */
+    struct Violation {
+        std::string path;     ///< Path of the violating node, e.g., `$.PORTS[0].input`.
+        std::string message;  ///< Description of the violation.
+    };
+
+    /**
+     * @brief Compiles a schema from its specification data node.
+     *
+     * @param spec Data node of the schema specification.
+     * @throws std::runtime_error If the specification is invalid.
+     */
+    explicit Schema(const DataNode& spec);
+
+    /**
+     * @brief Compiles a schema from a YAML/JSON specification file.
+     *
+     * @param file_path Path of the schema specification file.
+     * @throws std::runtime_error If the file cannot be read or the specification is invalid.
+     */
+    explicit Schema(const std::string& file_path);
+
+    /**
+     * @brief Validates a document against the schema in a single traversal.
+     *
+     * @param document Data node to validate.
+     * @returns All violations found in the document (empty if the document is valid).
+     */
+    std::vector<Violation> validate(const DataNode& document) const;
+
+    /**
+     * @brief Returns whether a document is valid according to the schema.
+     *
+     * @param document Data node to validate.
+     * @returns True if no violation was found, false otherwise.
+     */
+    bool isValid(const DataNode& document) const;
+
+private:
+    /**
+     * @brief Expected type of a node.
+     */
+    enum class ValueType : uint8_t {
+        kAny, kMap, kSeq, kScalar, kStr, kInt, kFloat, kBool, kNull
+    };
+
+    /**
+     * @brief Compiled rule for one node of the schema.
+     */
+    struct Rule {
+        ValueType type = ValueType::kAny;        ///< Expected type of the node.
+        bool is_nullable = false;                ///< Whether a null value is allowed.
+        bool allow_additional = true;            ///< Whether unlisted keys are allowed.
+        size_t min_size = 0;                     ///< Minimum number of children.
+        size_t max_size = SIZE_MAX;              ///< Maximum number of children.
+        std::vector<std::string> enum_values;    ///< Allowed scalar values (empty: any).
+        std::vector<std::string> property_keys;  ///< Sorted keys of the listed properties.
+        std::vector<size_t> property_rules;      ///< Rule indices of the listed properties.
+        std::vector<size_t> required;            ///< Property indices of the required keys.
+        size_t values_rule = SIZE_MAX;           ///< Rule index of unlisted map values.
+        size_t items_rule = SIZE_MAX;            ///< Rule index of sequence items.
+    };
+
+    /**
+     * @brief Mutable state of a validation run.
+     */
+    struct Context {
+        std::vector<Violation> violations;  ///< Violations found so far.
+        std::string path;                   ///< Path of the current node.
+        std::vector<uint8_t> seen;          ///< Stack of flags of the found required keys.
+    };
+
+    /**
+     * @brief Compiles a schema node (recursively) and appends its rule(s).
+     *
+     * @param spec Data node of the schema specification.
+     * @param path Path of the schema node (for error messages).
+     * @returns Index of the compiled rule.
+     */
+    size_t compileRule(const DataNode& spec, const std::string& path);
+
+    /**
+     * @brief Validates a node against a rule (recursively).
+     *
+     * @param node Node to validate.
+     * @param rule_id Index of the rule.
+     * @param ctx Validation context.
+     */
+    void validateNode(const DataNode& node, size_t rule_id, Context& ctx) const;
+
+    /**
+     * @brief Adds a violation for the current node to the context.
+     */
+    static void addViolation(Context& ctx, std::string message);
+
+    /// Compiled rules (index 0 is the root rule).
+    std::vector<Rule> rules_;
+};
+
+} // namespace icarus
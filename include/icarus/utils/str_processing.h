@@ -7,7 +7,11 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace icarus::utils {
@@ -15,33 +19,362 @@ namespace icarus::utils {
 /// @addtogroup StringProcessing
 /// @{
 
+/**
+ * @brief Flat hash set of strings with lookup by string view.
+ * 
+ * The set uses open addressing with linear probing and stores the hash of each string
+ * next to its slot, so that most mismatches are rejected without comparing strings.
+ * The strings are kept in insertion order and can be addressed by their index.
+ */
+class StringSet {
+public:
+    /// Index returned by StringSet::find if the string is not contained.
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Constructs an empty set.
+     */
+    StringSet() = default;
+
+    /**
+     * @brief Constructs a set from the strings of a vector (duplicates are ignored).
+     * 
+     * @param strs Strings to insert.
+     */
+    explicit StringSet(const std::vector<std::string>& strs);
+
+    /**
+     * @brief Inserts a string if it is not yet contained.
+     * 
+     * @param str String to insert.
+     * @returns True if the string was inserted, false if it was already contained.
+     */
+    bool insert(std::string_view str);
+
+    /**
+     * @brief Checks whether a string is contained in the set.
+     * 
+     * @param str String to search for.
+     * @returns True if the string is contained, false otherwise.
+     */
+    bool contains(std::string_view str) const { return find(str) != npos; }
+
+    /**
+     * @brief Finds a string in the set.
+     * 
+     * @param str String to search for.
+     * @returns Insertion index of the string, or StringSet::npos if it is not contained.
+     */
+    size_t find(std::string_view str) const;
+
+    /**
+     * @brief Reserves slots for a number of strings to avoid rehashing.
+     * 
+     * @param num_strings Number of strings to reserve for.
+     */
+    void reserve(size_t num_strings);
+
+    /**
+     * @brief Removes all strings from the set.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of strings in the set.
+     * 
+     * @returns Number of strings.
+     */
+    size_t size() const { return strings_.size(); }
+
+    /**
+     * @brief Checks whether the set is empty.
+     * 
+     * @returns True if the set contains no strings, false otherwise.
+     */
+    bool empty() const { return strings_.empty(); }
+
+    /**
+     * @brief Returns the strings of the set in insertion order.
+     * 
+     * @returns Strings of the set.
+     */
+    const std::vector<std::string>& getStrings() const { return strings_; }
+
+    /**
+     * @brief Computes the 64-bit hash of a string used by the set.
+     * 
+     * @param str String to hash.
+     * @returns Hash of the string.
+     */
+    static uint64_t hashString(std::string_view str);
+
+private:
+    /**
+     * @brief Slot of the hash table.
+     */
+    struct Slot {
+        uint64_t hash = 0;   ///< Hash of the string.
+        uint32_t index = 0;  ///< Index of the string + 1 (0 for empty slots).
+    };
+
+    /**
+     * @brief Finds the slot of a string or the empty slot where it would be inserted.
+     * 
+     * @param str String to search for.
+     * @param hash Hash of the string.
+     * @returns Position of the slot.
+     */
+    size_t findSlot(std::string_view str, uint64_t hash) const;
+
+    /**
+     * @brief Rebuilds the table with a given number of slots.
+     * 
+     * @param num_slots Number of slots (power of two).
+     */
+    void rehash(size_t num_slots);
+
+    /// Strings in insertion order.
+    std::vector<std::string> strings_;
+    /// Hashes of the strings in insertion order.
+    std::vector<uint64_t> hashes_;
+    /// Slots of the hash table (at most half full).
+    std::vector<Slot> slots_;
+};
+
+/**
+ * @brief Lazy range of the tokens of a string split at delimiters.
+ * 
+ * The tokens are views into the input string, which must outlive the range and its
+ * iterators; no memory is allocated while iterating. A string is split at a single
+ * character, at a multi-character string, or at any character of a set, e.g.:
+ * 
+ *     for (std::string_view token : SplitRange(names, ',').trim().skipEmpty()) { ... }
+ * 
+ * Without skipping, an empty input or consecutive delimiters yield empty tokens.
+ */
+class SplitRange {
+public:
+    class Iterator;
+
+    /**
+     * @brief Creates a range splitting a string at a delimiter character.
+     * 
+     * @param str String to split.
+     * @param delimiter Delimiter character.
+     */
+    SplitRange(std::string_view str, char delimiter);
+
+    /**
+     * @brief Creates a range splitting a string at a delimiter string.
+     * 
+     * @param str String to split.
+     * @param delimiter Delimiter string (an empty delimiter does not split).
+     */
+    SplitRange(std::string_view str, std::string_view delimiter);
+
+    /**
+     * @brief Creates a range splitting a string at any character of a set.
+     * 
+     * @param str String to split.
+     * @param delimiters Set of delimiter characters.
+     * @returns Range of the tokens.
+     */
+    static SplitRange anyOf(std::string_view str, std::string_view delimiters);
+
+    /**
+     * @brief Returns a copy of the range which trims whitespaces from the tokens.
+     * 
+     * @returns Range of the trimmed tokens.
+     */
+    SplitRange trim() const;
+
+    /**
+     * @brief Returns a copy of the range which skips empty tokens (after trimming).
+     * 
+     * @returns Range of the non-empty tokens.
+     */
+    SplitRange skipEmpty() const;
+
+    /**
+     * @brief Returns a copy of the range which splits at most a given number of times.
+     * 
+     * After max_splits tokens, the rest of the string is returned as last token.
+     * 
+     * @param max_splits Maximum number of splits.
+     * @returns Range with at most max_splits + 1 tokens.
+     */
+    SplitRange maxSplits(size_t max_splits) const;
+
+    /**
+     * @brief Returns the iterator to the first token.
+     * 
+     * @returns Iterator to the first token.
+     */
+    Iterator begin() const;
+
+    /**
+     * @brief Returns the end iterator.
+     * 
+     * @returns Iterator past the last token.
+     */
+    Iterator end() const;
+
+    /**
+     * @brief Collects all tokens into a vector.
+     * 
+     * @returns Views of the tokens in order.
+     */
+    std::vector<std::string_view> toVector() const;
+
+private:
+    /**
+     * @brief Kind of delimiter.
+     */
+    enum class Mode : uint8_t {
+        kChar,    ///< Single delimiter character.
+        kString,  ///< Delimiter string.
+        kAnyOf    ///< Any character of a set.
+    };
+
+    /**
+     * @brief Finds the next delimiter.
+     * 
+     * @param pos Position to start searching at.
+     * @param length Set to the length of the found delimiter.
+     * @returns Position of the delimiter, or std::string_view::npos if there is none.
+     */
+    size_t findDelimiter(size_t pos, size_t& length) const;
+
+    /// String to split.
+    std::string_view str_;
+    /// Delimiter string or set of delimiter characters.
+    std::string_view delimiter_;
+    /// Delimiter character (Mode::kChar).
+    char delimiter_char_ = '\0';
+    /// Kind of delimiter.
+    Mode mode_ = Mode::kChar;
+    /// Flag to trim whitespaces from the tokens.
+    bool is_trimmed_ = false;
+    /// Flag to skip empty tokens.
+    bool skips_empty_ = false;
+    /// Maximum number of splits.
+    size_t max_splits_ = static_cast<size_t>(-1);
+};
+
+/**
+ * @brief Forward iterator over the tokens of a SplitRange.
+ */
+class SplitRange::Iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    /**
+     * @brief Creates an end iterator of an empty range.
+     */
+    Iterator() : range_(std::string_view(), '\0'), is_end_(true) {}
+
+    reference operator*() const { return token_; }
+    pointer operator->() const { return &token_; }
+
+    /**
+     * @brief Advances to the next token.
+     * 
+     * @returns Reference to the advanced iterator.
+     */
+    Iterator& operator++();
+
+    Iterator operator++(int) {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const Iterator& other) const {
+        return is_end_ == other.is_end_ && (is_end_ || next_pos_ == other.next_pos_);
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+private:
+    friend class SplitRange;
+
+    /**
+     * @brief Creates an iterator at the first token, or an end iterator.
+     */
+    Iterator(const SplitRange& range, bool is_end);
+
+    /// Configuration and input of the split.
+    SplitRange range_;
+    /// Start of the rest of the string after the current token, npos after the last one.
+    size_t next_pos_ = 0;
+    /// Number of tokens produced so far.
+    size_t num_tokens_ = 0;
+    /// Current token.
+    std::string_view token_;
+    /// Flag whether the iterator is past the last token.
+    bool is_end_ = false;
+};
+
 /**
  * @brief Trims leading and trailing whitespaces from a string.
  * 
  * This function does not modify the input string and creates a new one for the result.
+ * Whitespaces are the ASCII characters space, \\t, \\n, \\v, \\f and \\r, independently
+ * of the locale.
  * 
  * @param str The string to trim.
  * @returns The trimmed string.
  */
-std::string trimStr(const std::string& str);
+std::string trimStr(std::string_view str);
+
+/**
+ * @brief Trims leading and trailing whitespaces from a string without copying it.
+ * 
+ * @param str The string to trim.
+ * @returns View of the trimmed part of the input string.
+ */
+std::string_view trimStrView(std::string_view str);
 
 /**
  * @brief Checks if a string contains at least one whitespace between words.
  * 
+ * The check is vectorized (SSE2/AVX2, selected at runtime) and locale-independent.
+ * 
  * @param str The string to check.
  * @returns True if the string contains whitespace, false otherwise.
  */
-bool containsWhitespace(const std::string& str);
+bool containsWhitespace(std::string_view str);
+
+/**
+ * @brief Checks each string of a vector for whitespaces.
+ * 
+ * @param strs The strings to check.
+ * @returns One flag per string, true if the string contains whitespace.
+ */
+std::vector<bool> containsWhitespace(const std::vector<std::string>& strs);
 
 /**
  * @brief Checks if a string contains special characters.
  * 
- * Special characters are all characters that are not letters, digits, or underscores.
+ * Special characters are all characters that are not ASCII letters, digits, underscores
+ * or hyphens. The check is vectorized (SSE2/AVX2, selected at runtime) and
+ * locale-independent.
  * 
  * @param str The string to check.
  * @returns True if the string contains special characters, false otherwise.
  */
-bool containsSpecialChars(const std::string& str);
+bool containsSpecialChars(std::string_view str);
+
+/**
+ * @brief Checks each string of a vector for special characters.
+ * 
+ * @param strs The strings to check.
+ * @returns One flag per string, true if the string contains special characters.
+ */
+std::vector<bool> containsSpecialChars(const std::vector<std::string>& strs);
 
 /**
  * @brief Checks if a specific string is contained in a vector of strings.
@@ -53,11 +386,23 @@ bool containsSpecialChars(const std::string& str);
 bool isInVector(const std::string& str, const std::vector<std::string>& str_vec);
 
 /**
- * @brief Splits a string into a pair of substrings using a given delimiter.
+ * @brief Checks if a specific string is contained in a string set in constant time.
+ * 
+ * @param str String to search for.
+ * @param str_set String set to search in.
+ * @returns True if the string is contained in the set, false otherwise.
+ */
+bool isInVector(std::string_view str, const StringSet& str_set);
+
+/**
+ * @brief Splits a string into a pair of substrings at the first occurrence of a delimiter.
+ * 
+ * See SplitRange for splitting into all tokens without allocations.
  * 
  * @param input The string to split.
  * @param delimiter The delimiter character(s) to split the string at.
- * @returns Pair of splitted substrings.
+ * @returns Pair of splitted substrings, or a pair of empty strings if the delimiter is
+ *          not found.
  */
 std::pair<std::string, std::string> splitString(const std::string& input, 
 												const char* delimiter);
@@ -65,16 +410,28 @@ std::pair<std::string, std::string> splitString(const std::string& input,
 /**
  * @brief Removes strings from a source vector that are contained in a second vector.
  * 
+ * For more than a few strings to remove, they are hashed into a StringSet first, so that
+ * the removal is linear in the sizes of both vectors.
+ * 
  * @param source The vector to remove strings from.
  * @param to_remove The vector containing the strings to remove.
  */
 void removeStringsFromVector(std::vector<std::string>& source, 
 							 const std::vector<std::string>& to_remove);
 
+/**
+ * @brief Removes strings from a source vector that are contained in a string set.
+ * 
+ * @param source The vector to remove strings from.
+ * @param to_remove The set containing the strings to remove.
+ */
+void removeStringsFromVector(std::vector<std::string>& source, const StringSet& to_remove);
+
 /**
  * @brief Prints a string preceded by a given indentation.
  * 
- * The indention is applied to all lines of the string in a consistent manner.
+ * The indention is applied to all lines of the string in a consistent manner. See
+ * IndentedWriter for nested indentation and other outputs.
  * 
  * @param message The string to print.
  * @param indent The indentation string.
@@ -0,0 +1,159 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/string_builder.h
+ * @brief Definition of the class StringBuilder.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "icarus/utils/system_ops.h"
+
+namespace icarus::utils {
+
+/**
+ * @brief Chunked string builder (rope) for generating or merging large texts.
+ *
+ * Text is appended into chunks which are never reallocated once filled, so existing data
+ * is not copied again as the text grows. Large strings and file contents are taken over
+ * as chunks of their own. The text is either joined once with toString() or written to a
+ * file chunk by chunk with vectored writes.
+ * @ingroup StringProcessing
+ */
+class StringBuilder {
+public:
+    /// Default capacity of the chunks in bytes.
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+    /**
+     * @brief Constructs an empty builder.
+     *
+     * @param chunk_size [opt] Capacity of the chunks in bytes.
+     */
+    explicit StringBuilder(size_t chunk_size = kDefaultChunkSize);
+
+    /**
+     * @brief Appends a copy of a string.
+     *
+     * @param str String to append.
+     * @returns Reference to the builder.
+     */
+    StringBuilder& append(std::string_view str);
+
+    /**
+     * @brief Appends a copy of a null-terminated string, e.g., a string literal.
+     *
+     * @param str String to append.
+     * @returns Reference to the builder.
+     */
+    StringBuilder& append(const char* str) { return append(std::string_view(str)); }
+
+    /**
+     * @brief Appends a character.
+     *
+     * @param c Character to append.
+     * @returns Reference to the builder.
+     */
+    StringBuilder& append(char c);
+
+    /**
+     * @brief Appends a string, taking it over as a chunk if it is large.
+     *
+     * @param str String to append.
+     * @returns Reference to the builder.
+     */
+    StringBuilder& append(std::string&& str);
+
+    /**
+     * @brief Appends the content of a file, read directly into a chunk sized from its size.
+     *
+     * @param file_path Path of the file to read.
+     * @returns Reference to the builder.
+     * @throws std::runtime_error If the file could not be read.
+     */
+    StringBuilder& appendFile(const std::string& file_path);
+
+    /**
+     * @brief Appends a copy of a string.
+     */
+    StringBuilder& operator<<(std::string_view str) { return append(str); }
+
+    /**
+     * @brief Appends a character.
+     */
+    StringBuilder& operator<<(char c) { return append(c); }
+
+    /**
+     * @brief Ensures that the next appends of a given size need no new chunk.
+     *
+     * @param num_bytes Number of bytes to be appended.
+     */
+    void reserve(size_t num_bytes);
+
+    /**
+     * @brief Returns the total size of the text.
+     *
+     * @returns Size of the text in bytes.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Checks whether the text is empty.
+     *
+     * @returns True if the text is empty, false otherwise.
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Returns views of the chunks in order.
+     *
+     * The views remain valid until the builder is modified.
+     *
+     * @returns Views of the non-empty chunks.
+     */
+    std::vector<std::string_view> getBuffers() const;
+
+    /**
+     * @brief Joins the chunks into one string.
+     *
+     * @returns Text of the builder.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Writes the text to a file without joining the chunks.
+     *
+     * @param file_path Path of the file to write.
+     * @param mode [opt] Mode of writing the file.
+     * @returns True if the file was written, false if the write was skipped.
+     * @throws std::runtime_error If the file cannot be opened, written or replaced.
+     */
+    bool writeToFile(const std::string& file_path, WriteMode mode = WriteMode::kTruncate) const;
+
+    /**
+     * @brief Removes the text and the chunks.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Returns the last chunk if it has room for a given size without reallocating.
+     *
+     * @param num_bytes Number of bytes to be appended.
+     * @returns Chunk to append to, a new chunk if the last one is full.
+     */
+    std::string& getChunk(size_t num_bytes);
+
+    /// Chunks of the text (appended to only within their capacity).
+    std::vector<std::string> chunks_;
+    /// Capacity of new chunks.
+    size_t chunk_size_;
+    /// Total size of the text.
+    size_t size_ = 0;
+};
+
+} // namespace icarus::utils
@@ -0,0 +1,241 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/symbol_pool.h
+ * @brief Definition of the classes Symbol and SymbolPool.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace icarus::utils {
+
+/// @addtogroup StringProcessing
+/// @{
+
+class SymbolPool;
+
+/**
+ * @brief Interned string, e.g., a port, feature or field name.
+ *
+ * A symbol refers to the single copy of its string in a symbol pool. Symbols of the same
+ * pool are equal if and only if their strings are equal, so comparing them is one integer
+ * comparison. Symbols stay valid as long as their pool exists (the global pool lives until
+ * the end of the program). The default symbol is the empty string.
+ */
+class Symbol {
+public:
+    /**
+     * @brief Constructs the empty symbol.
+     */
+    Symbol();
+
+    /**
+     * @brief Interns a string in the global pool.
+     *
+     * @param str String to intern.
+     */
+    explicit Symbol(std::string_view str);
+
+    /**
+     * @brief Returns the ID of the symbol, unique within its pool (0 for the empty symbol).
+     *
+     * @returns ID of the symbol.
+     */
+    uint32_t getId() const { return entry_->id; }
+
+    /**
+     * @brief Returns the interned string.
+     *
+     * @returns View of the interned string (null-terminated).
+     */
+    std::string_view getView() const { return {entry_->data, entry_->size}; }
+
+    /**
+     * @brief Returns the interned string as a C string.
+     *
+     * @returns Pointer to the null-terminated string.
+     */
+    const char* c_str() const { return entry_->data; }
+
+    /**
+     * @brief Checks whether the symbol is the empty string.
+     *
+     * @returns True if the symbol is empty, false otherwise.
+     */
+    bool empty() const { return entry_->size == 0; }
+
+    /**
+     * @brief Converts the symbol into a string view.
+     */
+    operator std::string_view() const { return getView(); }
+
+    bool operator==(const Symbol& other) const { return entry_ == other.entry_; }
+    bool operator!=(const Symbol& other) const { return entry_ != other.entry_; }
+
+    /// Orders symbols by ID (not alphabetically).
+    bool operator<(const Symbol& other) const { return entry_->id < other.entry_->id; }
+
+private:
+    friend class SymbolPool;
+
+    /**
+     * @brief Interned string with its ID.
+     */
+    struct Entry {
+        uint32_t id;       ///< ID of the symbol.
+        uint32_t size;     ///< Size of the string.
+        const char* data;  ///< Null-terminated string in the pool.
+    };
+
+    /// Entry of the empty symbol, shared by all pools.
+    static const Entry kEmptyEntry;
+
+    /**
+     * @brief Constructs a symbol from an entry of a pool.
+     */
+    explicit Symbol(const Entry* entry) : entry_(entry) {}
+
+    /// Entry of the symbol.
+    const Entry* entry_;
+};
+
+/**
+ * @brief Thread-safe pool of interned strings.
+ *
+ * The pool is split into shards selected by the hash of the string, each with its own
+ * reader-writer lock, so that lookups of existing symbols only take a shared lock and
+ * insertions into different shards do not contend. Strings are copied once into arena
+ * blocks and never moved or freed before the pool is destroyed.
+ */
+class SymbolPool {
+public:
+    /// Number of shards (power of two).
+    static constexpr size_t kNumShards = 16;
+
+    /**
+     * @brief Constructs an empty pool.
+     */
+    SymbolPool() = default;
+
+    SymbolPool(const SymbolPool&) = delete;
+    SymbolPool& operator=(const SymbolPool&) = delete;
+
+    /**
+     * @brief Returns the global pool used by Symbol(std::string_view).
+     *
+     * @returns Reference to the global pool.
+     */
+    static SymbolPool& getGlobal();
+
+    /**
+     * @brief Interns a string, adding it to the pool if needed.
+     *
+     * @param str String to intern.
+     * @returns Symbol of the string.
+     * @throws std::runtime_error If the pool or the string exceeds the 32-bit limits.
+     */
+    Symbol intern(std::string_view str);
+
+    /**
+     * @brief Interns a list of strings.
+     *
+     * @param strings Strings to intern.
+     * @returns Symbols of the strings in the same order.
+     */
+    std::vector<Symbol> intern(const std::vector<std::string>& strings);
+
+    /**
+     * @brief Looks up a string without adding it.
+     *
+     * @param str String to look up.
+     * @returns Symbol of the string if it was interned, std::nullopt otherwise.
+     */
+    std::optional<Symbol> find(std::string_view str) const;
+
+    /**
+     * @brief Returns the symbol with a given ID.
+     *
+     * @param id ID of the symbol.
+     * @returns Symbol with the ID.
+     * @throws std::runtime_error If no symbol of the pool has the ID.
+     */
+    Symbol getSymbol(uint32_t id) const;
+
+    /**
+     * @brief Returns the number of interned strings (without the empty string).
+     *
+     * @returns Number of symbols.
+     */
+    size_t size() const;
+
+private:
+    /// Number of bits of the shard index in the symbol IDs.
+    static constexpr uint32_t kShardBits = 4;
+    /// Size of the arena blocks holding the strings.
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    static_assert((size_t{1} << kShardBits) == kNumShards);
+
+    /**
+     * @brief Hash functor of the shard maps.
+     */
+    struct Hasher {
+        size_t operator()(std::string_view str) const;
+    };
+
+    /**
+     * @brief Part of the pool with its own lock.
+     */
+    struct Shard {
+        /// Lock of the shard.
+        mutable std::shared_mutex mutex;
+        /// Entry of each interned string (keys point into the arena).
+        std::unordered_map<std::string_view, const Symbol::Entry*, Hasher> symbols;
+        /// Entries in order of their local index (stable addresses).
+        std::deque<Symbol::Entry> entries;
+        /// Arena blocks and large strings.
+        std::vector<std::unique_ptr<char[]>> blocks;
+        /// Current arena block.
+        char* block = nullptr;
+        /// Number of used bytes of the current arena block.
+        size_t block_used = kBlockSize;
+    };
+
+    /**
+     * @brief Copies a string with its null terminator into the arena of a shard.
+     *
+     * @param shard Shard to allocate in (locked by the caller).
+     * @param str String to copy.
+     * @returns Pointer to the copy.
+     */
+    static const char* storeString(Shard& shard, std::string_view str);
+
+    /// Shards of the pool.
+    std::array<Shard, kNumShards> shards_;
+};
+
+/// @}
+
+} // namespace icarus::utils
+
+/**
+ * @brief Hash of a symbol (its ID).
+ */
+template <>
+struct std::hash<icarus::utils::Symbol> {
+    size_t operator()(const icarus::utils::Symbol& symbol) const noexcept {
+        return std::hash<uint32_t>()(symbol.getId());
+    }
+};
@@ -7,8 +7,12 @@
  */
 #pragma once
 
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace icarus::utils {
@@ -41,6 +45,9 @@ void openFile(const std::string& file_path);
 /**
  * @brief Executes a system command and returns its output as a string.
  *
+ * The command is interpreted by the shell. Use runProcess() to run a program with an
+ * argument list, capture stderr or apply a timeout.
+ *
  * @param cmd Input command as char array.
  * @returns Output of the command as string.
  * @throws std::runtime_error If the process pipe could not be opened or the command failed.
@@ -68,31 +75,120 @@ std::string removeExtension(const std::string& filename);
 /**
  * @brief Gets the content of a file as a string.
  *
+ * The string is sized once from the file size and filled with large reads. For large
+ * files that are only scanned, MappedFile avoids the copy altogether.
+ *
  * @param file_path Path of the file to read.
  * @returns Content of the file as a string.
  * @throws std::runtime_error If the file could not be read.
  */
 std::string getFileContent(const std::string& file_path);
 
+/**
+ * @brief Appends the content of a file to a string, reading directly into its storage.
+ *
+ * The string grows once by the file size, so reserving the total size beforehand avoids
+ * any reallocation when appending several files. If the file cannot be read, the string
+ * is left unchanged.
+ *
+ * @param file_path Path of the file to read.
+ * @param content String to append the content to.
+ * @throws std::runtime_error If the file could not be read.
+ */
+void appendFileContent(const std::string& file_path, std::string& content);
+
 /**
  * @brief Merges the content of multiple files into a single string and returns it.
  *
+ * Each file is followed by a line break. The result is sized once from the file sizes
+ * and each file is read directly into it.
+ *
  * @param file_paths Paths of the files to merge.
  * @returns Merged content of the files as a string.
+ * @throws std::runtime_error If a file could not be read.
  */
 std::string getMergedContent(const std::vector<std::string>& file_paths);
 
+/**
+ * @brief Result of an asynchronous file read.
+ */
+struct FileReadResult {
+    size_t index = 0;          ///< Index of the file in the requested list.
+    std::string content;       ///< Content of the file (empty on error).
+    std::exception_ptr error;  ///< Error of the read, if any.
+};
+
+/**
+ * @brief Reads multiple files asynchronously on the I/O thread pool.
+ *
+ * Readahead is requested for the whole batch first (posix_fadvise on Linux), so that the
+ * reads of the pool overlap with the kernel loading the following files.
+ *
+ * @param file_paths Paths of the files to read.
+ * @returns Futures of the file contents in the order of the paths (holding the
+ *          std::runtime_error of a failed read).
+ */
+std::vector<std::future<std::string>> readFilesAsync(const std::vector<std::string>& file_paths);
+
+/**
+ * @brief Reads multiple files on the I/O thread pool and delivers them in completion order.
+ *
+ * The callback is invoked on the calling thread, one result at a time, as soon as a read
+ * completes. The function returns after all files were delivered. It must not be called
+ * from a task of the I/O pool.
+ *
+ * @param file_paths Paths of the files to read.
+ * @param callback Function receiving each result (with the error of a failed read).
+ * @throws Exception thrown by the callback, after all reads completed.
+ */
+void readFilesAsync(const std::vector<std::string>& file_paths,
+                    const std::function<void(FileReadResult&&)>& callback);
+
+/**
+ * @brief Mode of writing content to a file.
+ */
+enum class WriteMode {
+    kTruncate,      ///< Truncate and rewrite the file in place.
+    kAtomic,        ///< Write to a temporary file and rename it to the target.
+    kSkipUnchanged  ///< Skip the write if the file content is identical, else write atomically.
+};
+
 /**
  * @brief Writes a string to a local file.
  *
  * @param str Input string to write.
  * @param file_path Path of the file to write the string to.
+ * @param mode [opt] Mode of writing the file.
+ * @returns True if the file was written, false if the write was skipped.
+ * @throws std::runtime_error If the file cannot be opened, written or replaced.
+ */
+bool writeStrToFile(const std::string& str, const std::string& file_path,
+                    WriteMode mode = WriteMode::kTruncate);
+
+/**
+ * @brief Writes the concatenation of several buffers to a local file.
+ *
+ * On Linux, the buffers are written with vectored writes without joining them first.
+ * With WriteMode::kSkipUnchanged, the existing file is compared to the buffers (size
+ * first, then content) and kept untouched, including its modification time, if equal.
+ * Atomic writes sync the temporary file to the disk before renaming it, keep the
+ * permissions of the replaced file and replace the target of a symbolic link.
+ *
+ * @param buffers Buffers to write in order.
+ * @param file_path Path of the file to write the buffers to.
+ * @param mode [opt] Mode of writing the file.
+ * @returns True if the file was written, false if the write was skipped.
+ * @throws std::runtime_error If the file cannot be opened, written or replaced.
  */
-void writeStrToFile(const std::string& str, const std::string& file_path);
+bool writeBuffersToFile(const std::vector<std::string_view>& buffers, const std::string& file_path,
+                        WriteMode mode = WriteMode::kTruncate);
 
 /**
  * @brief Checks if a file at a given path is a valid file with a specified extension.
  *
+ * The reason of an invalid file is printed to stderr. For many queries within a directory
+ * tree, FileIndex answers from memory instead.
+ *
  * @param file_path Path of the file to check.
  * @param extension Extension of the file to check for, e.g., "txt" or "yaml".
  * @returns True if the file exists and has the correct extension, false otherwise.
@@ -0,0 +1,123 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the MIT License.
+ *
+ * @file icarus/utils/thread_pool.h
+ * @brief Definition of the class ThreadPool.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace icarus::utils {
+
+/**
+ * @brief Fixed-size pool of worker threads executing queued tasks.
+ *
+ * Queued tasks are executed in FIFO order. Tasks must not block on the results of other
+ * tasks of the same pool, as this may deadlock when all workers are waiting.
+ * @ingroup SystemOps
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Creates a thread pool and starts its worker threads.
+     *
+     * @param num_threads [opt] Number of worker threads (0: number of hardware threads).
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+
+    /**
+     * @brief Executes all queued tasks and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution.
+     *
+     * @param task Callable without arguments.
+     * @returns Future of the result of the task (holding its exception, if any).
+     */
+    template<typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged_task->get_future();
+        enqueue([packaged_task]() { (*packaged_task)(); });
+        return future;
+    }
+
+    /**
+     * @brief Returns the number of worker threads.
+     *
+     * @returns Number of worker threads.
+     */
+    size_t getNumThreads() const;
+
+    /**
+     * @brief Checks whether the calling thread is a worker thread of the pool.
+     *
+     * Callers blocking on the results of tasks should execute them inline instead when
+     * this is true, as waiting from a worker may deadlock the pool.
+     *
+     * @returns True if called from a task executed by the pool.
+     */
+    bool isWorkerThread() const;
+
+    /**
+     * @brief Returns the process-wide pool with one worker per hardware thread.
+     *
+     * @returns Reference to the shared pool.
+     */
+    static ThreadPool& getShared();
+
+    /**
+     * @brief Returns the process-wide pool for blocking I/O with kNumIoThreads workers.
+     *
+     * I/O tasks mostly wait on the disk, so the pool is sized to keep enough requests in
+     * flight independently of the number of hardware threads.
+     *
+     * @returns Reference to the I/O pool.
+     */
+    static ThreadPool& getIo();
+
+    /// Number of worker threads of the I/O pool.
+    static constexpr size_t kNumIoThreads = 16;
+
+private:
+    /**
+     * @brief Appends a job to the queue and wakes up a worker.
+     *
+     * @param job Job to execute.
+     */
+    void enqueue(std::function<void()> job);
+
+    /**
+     * @brief Loop of a worker thread executing jobs until the pool is stopped.
+     */
+    void run();
+
+    /// Worker threads.
+    std::vector<std::thread> workers_;
+    /// Queued jobs.
+    std::queue<std::function<void()>> jobs_;
+    /// Mutex protecting the queue and the stop flag.
+    std::mutex mutex_;
+    /// Condition variable signaling new jobs or stopping.
+    std::condition_variable cv_;
+    /// Flag to stop the workers once the queue is empty.
+    bool is_stopping_ = false;
+};
+
+} // namespace icarus::utils
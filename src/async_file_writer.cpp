@@ -0,0 +1,222 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/async_file_writer.cpp
+ * @brief Implementation of the class AsyncFileWriter.
+ */
+#include "icarus/utils/async_file_writer.h"
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace icarus::utils {
+
+namespace {
+
+/**
+ * @brief Flushes a file or directory to the disk.
+ *
+ * @param path Path of the file or directory.
+ * @throws std::runtime_error If the path cannot be opened or synced.
+ */
+void syncPath(const std::string& path) {
+    #ifdef __linux__
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error("Could not open for syncing: " + path + " (" +
+                                     std::strerror(errno) + ")");
+        }
+        if (fsync(fd) == -1) {
+            std::string error = std::strerror(errno);
+            close(fd);
+            throw std::runtime_error("Could not sync: " + path + " (" + error + ")");
+        }
+        close(fd);
+    #else
+        (void)path;
+    #endif
+}
+
+/**
+ * @brief Flushes a written file to the disk, including the rename of an atomic write.
+ *
+ * Atomic writes already sync the content of the file before renaming it, so only its
+ * directory is synced then. Directories are synced once per batch.
+ *
+ * @param file_path Path of the written file.
+ * @param mode Mode the file was written with.
+ * @param synced_dirs Directories synced so far in the batch.
+ * @throws std::runtime_error If the file or its directory cannot be synced.
+ */
+void syncFile(const std::string& file_path, WriteMode mode, std::vector<std::string>& synced_dirs) {
+    if (mode == WriteMode::kTruncate) {
+        syncPath(file_path);
+        return;
+    }
+
+    // The rename replaced the target of a symbolic link
+    std::error_code error;
+    fs::path target_path = fs::canonical(file_path, error);
+    std::string dir_path = (error ? fs::absolute(file_path) : target_path).parent_path().string();
+    if (std::find(synced_dirs.begin(), synced_dirs.end(), dir_path) == synced_dirs.end()) {
+        syncPath(dir_path);
+        synced_dirs.push_back(dir_path);
+    }
+}
+
+} // namespace
+
+AsyncFileWriter::AsyncFileWriter(AsyncWriteOptions options) : options_(options) {
+    options_.num_threads = std::max<size_t>(options_.num_threads, 1);
+    options_.max_batch_size = std::max<size_t>(options_.max_batch_size, 1);
+
+    workers_.reserve(options_.num_threads);
+    for (size_t i = 0; i < options_.num_threads; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::future<bool> AsyncFileWriter::write(std::string file_path, std::string content) {
+    Job job;
+    job.file_path = std::move(file_path);
+    job.buffers.push_back(std::move(content));
+    return enqueue(std::move(job));
+}
+
+std::future<bool> AsyncFileWriter::write(std::string file_path, std::vector<std::string> buffers) {
+    Job job;
+    job.file_path = std::move(file_path);
+    job.buffers = std::move(buffers);
+    return enqueue(std::move(job));
+}
+
+std::string AsyncFileWriter::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_buffers_.empty()) {
+        return std::string();
+    }
+    std::string buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return num_pending_ == 0; });
+}
+
+size_t AsyncFileWriter::getNumPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_pending_;
+}
+
+std::future<bool> AsyncFileWriter::enqueue(Job job) {
+    std::future<bool> future = job.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+        ++num_pending_;
+    }
+    cv_.notify_one();
+    return future;
+}
+
+void AsyncFileWriter::run() {
+    std::vector<Job> batch;
+    std::vector<std::string_view> views;
+    std::vector<std::string> synced_dirs;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return is_stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // Stopping and no jobs left
+            }
+            size_t batch_size = std::min(jobs_.size(), options_.max_batch_size);
+            for (size_t i = 0; i < batch_size; ++i) {
+                batch.push_back(std::move(jobs_.front()));
+                jobs_.pop_front();
+            }
+        }
+
+        // Write the whole batch, then sync the written files and complete the futures
+        std::vector<std::exception_ptr> errors(batch.size());
+        std::vector<bool> results(batch.size(), false);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            views.assign(batch[i].buffers.begin(), batch[i].buffers.end());
+            try {
+                results[i] = writeBuffersToFile(views, batch[i].file_path, options_.mode);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+        if (options_.is_synced) {
+            synced_dirs.clear();
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (!results[i]) {
+                    continue;  // Failed or skipped as unchanged
+                }
+                try {
+                    syncFile(batch[i].file_path, options_.mode, synced_dirs);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (errors[i]) {
+                batch[i].promise.set_exception(errors[i]);
+            }
+            else {
+                batch[i].promise.set_value(results[i]);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& job : batch) {
+                recycleBuffers(job.buffers);
+            }
+            num_pending_ -= batch.size();
+        }
+        batch.clear();
+        done_cv_.notify_all();
+    }
+}
+
+void AsyncFileWriter::recycleBuffers(std::vector<std::string>& buffers) {
+    for (auto& buffer : buffers) {
+        if (free_buffers_.size() >= kMaxFreeBuffers) {
+            return;
+        }
+        if (buffer.capacity() >= kMinRecycledCapacity) {
+            buffer.clear();
+            free_buffers_.push_back(std::move(buffer));
+        }
+    }
+}
+
+} // namespace icarus::utils
@@ -0,0 +1,688 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/binary_log.cpp
+ * @brief Implementation of the class BinaryLogger.
+ */
+#include "icarus/utils/binary_log.h"
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/sink.h>
+#ifdef SPDLOG_FMT_EXTERNAL
+    #include <fmt/args.h>
+#else
+    #include <spdlog/fmt/bundled/args.h>
+#endif
+
+#include "icarus/utils/system_ops.h"
+
+namespace icarus {
+
+namespace {
+
+/// Format ID marking the padding at the end of a ring buffer.
+constexpr uint32_t kPaddingId = UINT32_MAX;
+/// Minimum capacity of a ring buffer in bytes.
+constexpr size_t kMinRingSize = 4096;
+/// Magic bytes at the beginning of a binary log file.
+constexpr char kFileMagic[8] = "ICBLOG1";
+/// Tag of a format definition in a binary log file.
+constexpr char kFormatTag = 'F';
+/// Tag of a record in a binary log file.
+constexpr char kRecordTag = 'R';
+
+/**
+ * @brief Registered formats of the process.
+ */
+struct FormatRegistry {
+    std::mutex mutex;                     ///< Mutex protecting the formats.
+    std::deque<BinaryLogFormat> formats;  ///< Formats by ID (stable references).
+};
+
+/**
+ * @brief Returns the format registry of the process.
+ *
+ * The registry is never destroyed, so that statements can be registered and decoded
+ * during static destruction.
+ *
+ * @returns Reference to the registry.
+ */
+FormatRegistry& getRegistry() {
+    static FormatRegistry* registry = new FormatRegistry();
+    return *registry;
+}
+
+/**
+ * @brief Appends the bytes of a value to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param value Trivially copyable value.
+ */
+template<typename T>
+void appendValue(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Appends a string with its length to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param str String to append.
+ */
+void appendString(std::string& buffer, std::string_view str) {
+    appendValue(buffer, static_cast<uint32_t>(str.size()));
+    buffer.append(str);
+}
+
+/**
+ * @brief Sequential reader of encoded data with bounds checks.
+ */
+class Reader {
+public:
+    /**
+     * @brief Creates a reader of a memory range.
+     *
+     * @param data Encoded data.
+     */
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    /**
+     * @brief Reads a trivially copyable value.
+     *
+     * @returns Value.
+     * @throws std::runtime_error If the data is truncated.
+     */
+    template<typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Reads a string with its length.
+     *
+     * @returns View of the string in the data.
+     * @throws std::runtime_error If the data is truncated.
+     */
+    std::string_view readString() {
+        return take(read<uint32_t>());
+    }
+
+    /**
+     * @brief Reads a number of bytes.
+     *
+     * @param size Number of bytes.
+     * @returns View of the bytes in the data.
+     * @throws std::runtime_error If the data is truncated.
+     */
+    std::string_view take(size_t size) {
+        if (size > data_.size() - pos_) {
+            throw std::runtime_error("Truncated binary log data.");
+        }
+        std::string_view bytes = data_.substr(pos_, size);
+        pos_ += size;
+        return bytes;
+    }
+
+    /**
+     * @brief Checks whether all data was read.
+     *
+     * @returns True if no data is left.
+     */
+    bool isAtEnd() const {
+        return pos_ == data_.size();
+    }
+
+private:
+    std::string_view data_;  ///< Encoded data.
+    size_t pos_ = 0;         ///< Read position.
+};
+
+/**
+ * @brief Formats the encoded arguments of a record.
+ *
+ * @param format Format of the record.
+ * @param args Encoded arguments.
+ * @returns Formatted message (with the error for invalid format strings).
+ * @throws std::runtime_error If the arguments are truncated.
+ */
+std::string formatMessage(const BinaryLogFormat& format, std::string_view args) {
+    Reader reader(args);
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    for (BinaryArgType type : format.arg_types) {
+        switch (type) {
+            case BinaryArgType::kBool:
+                store.push_back(reader.read<char>() != 0);
+                break;
+            case BinaryArgType::kChar:
+                store.push_back(reader.read<char>());
+                break;
+            case BinaryArgType::kInt:
+                store.push_back(reader.read<int64_t>());
+                break;
+            case BinaryArgType::kUInt:
+                store.push_back(reader.read<uint64_t>());
+                break;
+            case BinaryArgType::kDouble:
+                store.push_back(reader.read<double>());
+                break;
+            case BinaryArgType::kString:
+                store.push_back(std::string(reader.readString()));
+                break;
+            case BinaryArgType::kPointer:
+                store.push_back(reinterpret_cast<const void*>(
+                    static_cast<uintptr_t>(reader.read<uint64_t>())));
+                break;
+        }
+    }
+
+    try {
+        return fmt::vformat(format.format, store);
+    } catch (const fmt::format_error& error) {
+        return "Invalid format string \"" + format.format + "\": " + error.what();
+    }
+}
+
+/**
+ * @brief Passes a decoded message to the sinks of a logger.
+ *
+ * @param logger Logger whose sinks receive the message.
+ * @param format Format of the record.
+ * @param time Time of the record in nanoseconds since the Unix epoch.
+ * @param thread_id ID of the logging thread.
+ * @param args Encoded arguments of the record.
+ */
+void sendMessage(spdlog::logger& logger, const BinaryLogFormat& format, int64_t time,
+                 size_t thread_id, std::string_view args) {
+    if (!logger.should_log(format.level)) {
+        return;
+    }
+
+    std::string text = formatMessage(format, args);
+    spdlog::source_loc location{format.file.c_str(), format.line, format.function.c_str()};
+    spdlog::log_clock::time_point time_point(
+        std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(time)));
+    spdlog::details::log_msg msg(time_point, location, logger.name(), format.level, text);
+    msg.thread_id = thread_id;
+    for (auto& sink : logger.sinks()) {
+        if (sink->should_log(msg.level)) {
+            sink->log(msg);
+        }
+    }
+    if (msg.level >= logger.flush_level()) {
+        for (auto& sink : logger.sinks()) {
+            sink->flush();
+        }
+    }
+}
+
+} // namespace
+
+// ================================
+// RingBuffer class
+// ================================
+
+/**
+ * @brief Lock-free ring buffer of records with one producing and one consuming thread.
+ *
+ * Records are stored contiguously; a record not fitting before the end of the buffer is
+ * preceded by a padding record filling the rest of the buffer.
+ */
+class BinaryLogger::RingBuffer {
+public:
+    /**
+     * @brief Creates a ring buffer.
+     *
+     * @param capacity Capacity in bytes (power of two).
+     * @param thread_id ID of the producing thread.
+     */
+    RingBuffer(size_t capacity, size_t thread_id)
+            : buffer_(capacity), mask_(capacity - 1), thread_id_(thread_id) {}
+
+    /**
+     * @brief Reserves space for a record (producer).
+     *
+     * @param size Size of the record (multiple of kRecordAlignment).
+     * @param is_blocking Flag to wait for free space instead of failing.
+     * @returns Pointer to the reserved space, nullptr if there is no space.
+     */
+    char* reserve(size_t size, bool is_blocking) {
+        size_t capacity = buffer_.size();
+        if (size > capacity / 2) {
+            return nullptr;
+        }
+        size_t offset = write_pos_ & mask_;
+        size_t padding = (offset + size > capacity) ? capacity - offset : 0;
+        while (write_pos_ + padding + size - cached_tail_ > capacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (write_pos_ + padding + size - cached_tail_ <= capacity) {
+                break;
+            }
+            if (!is_blocking || is_orphaned_.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+
+        if (padding > 0) {
+            RecordHeader header{static_cast<uint32_t>(padding), kPaddingId, 0};
+            std::memcpy(&buffer_[offset], &header, sizeof(header));
+            write_pos_ += padding;
+            offset = 0;
+        }
+        return &buffer_[offset];
+    }
+
+    /**
+     * @brief Publishes the reserved record (producer).
+     *
+     * @param size Size of the record.
+     */
+    void commit(size_t size) {
+        write_pos_ += size;
+        head_.store(write_pos_, std::memory_order_release);
+    }
+
+    /**
+     * @brief Passes all published records to a callback and frees their space (consumer).
+     *
+     * @param callback Callable taking the header and the record.
+     */
+    template<typename F>
+    void consume(F&& callback) {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail != head) {
+            const char* record = &buffer_[tail & mask_];
+            RecordHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            if (header.format_id != kPaddingId) {
+                callback(header, record);
+            }
+            tail += header.size;
+            tail_.store(tail, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Returns the ID of the producing thread.
+     *
+     * @returns Thread ID.
+     */
+    size_t getThreadId() const {
+        return thread_id_;
+    }
+
+    /**
+     * @brief Marks the ring buffer as no longer drained by its logger.
+     */
+    void setOrphaned() {
+        is_orphaned_.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks whether the logger of the ring buffer was destroyed.
+     *
+     * @returns True if orphaned.
+     */
+    bool isOrphaned() const {
+        return is_orphaned_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Marks the ring buffer as complete, as its producing thread exits (producer).
+     */
+    void setFinished() {
+        is_finished_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Checks whether the producing thread exited (consumer).
+     *
+     * Once true, all records are published, so the ring buffer is complete after the
+     * next call of consume().
+     *
+     * @returns True if finished.
+     */
+    bool isFinished() const {
+        return is_finished_.load(std::memory_order_acquire);
+    }
+
+private:
+    static_assert(sizeof(RecordHeader) <= kRecordAlignment, "Padding records must fit into the alignment");
+
+    /// Storage of the records.
+    std::vector<char> buffer_;
+    /// Mask mapping positions to offsets.
+    size_t mask_;
+    /// ID of the producing thread.
+    size_t thread_id_;
+    /// Position behind the last published record.
+    alignas(64) std::atomic<size_t> head_{0};
+    /// Position of the first unconsumed record.
+    alignas(64) std::atomic<size_t> tail_{0};
+    /// Write position of the producer.
+    alignas(64) size_t write_pos_ = 0;
+    /// Last tail seen by the producer.
+    size_t cached_tail_ = 0;
+    /// Flag whether the logger was destroyed.
+    std::atomic<bool> is_orphaned_{false};
+    /// Flag whether the producing thread exited.
+    std::atomic<bool> is_finished_{false};
+};
+
+// ================================
+// BinaryLogger class
+// ================================
+
+BinaryLogger::BinaryLogger(std::shared_ptr<spdlog::logger> logger, BinaryLogConfig config)
+        : config_(config), logger_(std::move(logger)) {
+    if (!logger_) {
+        throw std::runtime_error("The binary logger requires an spdlog logger.");
+    }
+    level_ = logger_->level();
+    start();
+}
+
+BinaryLogger::BinaryLogger(const std::string& file_path, BinaryLogConfig config)
+        : config_(config), file_(std::fopen(file_path.c_str(), "wb")) {
+    if (file_ == nullptr) {
+        throw std::runtime_error("The binary log file could not be opened: " + file_path);
+    }
+    std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file_);
+    start();
+}
+
+BinaryLogger::~BinaryLogger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+
+    for (auto& ring : rings_) {
+        ring->setOrphaned();
+    }
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+void BinaryLogger::setLevel(spdlog::level::level_enum level) {
+    level_.store(level, std::memory_order_relaxed);
+}
+
+spdlog::level::level_enum BinaryLogger::getLevel() const {
+    return static_cast<spdlog::level::level_enum>(level_.load(std::memory_order_relaxed));
+}
+
+void BinaryLogger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // The next drain may have started before the call, so wait for the one after it
+    uint64_t target = num_drains_ + 2;
+    flush_target_ = std::max(flush_target_, target);
+    cv_.notify_all();
+    done_cv_.wait(lock, [this, target]() { return num_drains_ >= target; });
+}
+
+size_t BinaryLogger::getNumDroppedRecords() const {
+    return num_dropped_.load(std::memory_order_relaxed);
+}
+
+size_t BinaryLogger::getNumRingBuffers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rings_.size();
+}
+
+uint32_t BinaryLogger::registerFormat(spdlog::level::level_enum level, const char* format,
+                                      const char* file, int line, const char* function,
+                                      std::vector<BinaryArgType> arg_types) {
+    BinaryLogFormat entry;
+    entry.level = level;
+    entry.format = format;
+    entry.file = (file != nullptr) ? file : "";
+    entry.line = line;
+    entry.function = (function != nullptr) ? function : "";
+    entry.arg_types = std::move(arg_types);
+
+    FormatRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.formats.push_back(std::move(entry));
+    return static_cast<uint32_t>(registry.formats.size() - 1);
+}
+
+const BinaryLogFormat& BinaryLogger::getFormat(uint32_t format_id) {
+    FormatRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (format_id >= registry.formats.size()) {
+        throw std::runtime_error("Unknown binary log format ID: " + std::to_string(format_id));
+    }
+    return registry.formats[format_id];
+}
+
+size_t BinaryLogger::decodeFile(const std::string& file_path,
+                                const std::shared_ptr<spdlog::logger>& logger) {
+    std::string content = utils::getFileContent(file_path);
+    Reader reader(content);
+    if (content.size() < sizeof(kFileMagic) ||
+        std::memcmp(reader.take(sizeof(kFileMagic)).data(), kFileMagic, sizeof(kFileMagic)) != 0) {
+        throw std::runtime_error("The file is not a binary log: " + file_path);
+    }
+
+    std::vector<std::unique_ptr<BinaryLogFormat>> formats;
+    size_t num_records = 0;
+    while (!reader.isAtEnd()) {
+        char tag = reader.read<char>();
+        if (tag == kFormatTag) {
+            auto format = std::make_unique<BinaryLogFormat>();
+            uint32_t id = reader.read<uint32_t>();
+            format->level = static_cast<spdlog::level::level_enum>(reader.read<uint8_t>());
+            format->line = reader.read<int32_t>();
+            uint32_t num_args = reader.read<uint32_t>();
+            for (char type : reader.take(num_args)) {
+                format->arg_types.push_back(static_cast<BinaryArgType>(type));
+            }
+            format->format = reader.readString();
+            format->file = reader.readString();
+            format->function = reader.readString();
+            if (id >= formats.size()) {
+                formats.resize(id + 1);
+            }
+            formats[id] = std::move(format);
+        }
+        else if (tag == kRecordTag) {
+            size_t thread_id = static_cast<size_t>(reader.read<uint64_t>());
+            RecordHeader header = reader.read<RecordHeader>();
+            if (header.size < sizeof(RecordHeader)) {
+                throw std::runtime_error("Invalid record in the binary log: " + file_path);
+            }
+            std::string_view args = reader.take(header.size - sizeof(RecordHeader));
+            if (header.format_id >= formats.size() || !formats[header.format_id]) {
+                throw std::runtime_error("Undefined format in the binary log: " + file_path);
+            }
+            sendMessage(*logger, *formats[header.format_id], header.time, thread_id, args);
+            ++num_records;
+        }
+        else {
+            throw std::runtime_error("Invalid entry in the binary log: " + file_path);
+        }
+    }
+    for (auto& sink : logger->sinks()) {
+        sink->flush();
+    }
+    return num_records;
+}
+
+void BinaryLogger::start() {
+    static std::atomic<uint64_t> next_id{1};
+    id_ = next_id++;
+
+    // Round the ring size up to a power of two
+    size_t ring_size = kMinRingSize;
+    while (ring_size < config_.ring_size) {
+        ring_size <<= 1;
+    }
+    config_.ring_size = ring_size;
+    worker_ = std::thread([this]() { run(); });
+}
+
+char* BinaryLogger::reserveRecord(size_t size) {
+    char* record = getThreadRing().reserve(size, config_.is_blocking);
+    if (record == nullptr) {
+        num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return record;
+}
+
+void BinaryLogger::commitRecord(size_t size) {
+    getThreadRing().commit(size);
+}
+
+BinaryLogger::RingBuffer& BinaryLogger::getThreadRing() {
+    // Loggers are identified by unique IDs, as addresses may be reused
+    thread_local uint64_t cached_id = 0;
+    thread_local RingBuffer* cached_ring = nullptr;
+    if (cached_id == id_) {
+        return *cached_ring;
+    }
+
+    // Rings of the thread, marked as finished on thread exit so that the loggers remove them
+    struct ThreadRings {
+        std::vector<std::pair<uint64_t, std::shared_ptr<RingBuffer>>> entries;
+        ~ThreadRings() {
+            for (auto& entry : entries) {
+                entry.second->setFinished();
+            }
+        }
+    };
+    thread_local ThreadRings thread_rings;
+
+    auto& entries = thread_rings.entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const auto& entry) { return entry.second->isOrphaned(); }),
+                  entries.end());
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [this](const auto& entry) { return entry.first == id_; });
+    if (it == entries.end()) {
+        auto ring = std::make_shared<RingBuffer>(config_.ring_size, spdlog::details::os::thread_id());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(ring);
+        }
+        entries.emplace_back(id_, std::move(ring));
+        it = entries.end() - 1;
+    }
+    cached_id = id_;
+    cached_ring = it->second.get();
+    return *cached_ring;
+}
+
+void BinaryLogger::run() {
+    std::vector<std::shared_ptr<RingBuffer>> rings;
+    std::vector<RingBuffer*> finished_rings;
+    while (true) {
+        bool is_stopping = false;
+        bool is_flushing = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, config_.poll_interval, [this]() {
+                return is_stopping_ || num_drains_ < flush_target_;
+            });
+            is_stopping = is_stopping_;
+            is_flushing = num_drains_ < flush_target_;
+            if (rings.size() != rings_.size()) {
+                rings = rings_;
+            }
+        }
+
+        // Rings of exited threads are complete after this drain and can be removed
+        finished_rings.clear();
+        for (const auto& ring : rings) {
+            if (ring->isFinished()) {
+                finished_rings.push_back(ring.get());
+            }
+        }
+        drain(rings);
+        if (is_stopping || is_flushing) {
+            if (file_ != nullptr) {
+                std::fflush(file_);
+            }
+            else if (logger_) {
+                for (auto& sink : logger_->sinks()) {
+                    sink->flush();
+                }
+            }
+        }
+
+        // Notify under the lock, as a flushing thread may destroy the logger right after
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!finished_rings.empty()) {
+            // Both lists lose the same rings, so that new rings are still detected by size
+            auto isFinished = [&finished_rings](const std::shared_ptr<RingBuffer>& ring) {
+                return std::find(finished_rings.begin(), finished_rings.end(), ring.get()) !=
+                       finished_rings.end();
+            };
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), isFinished), rings_.end());
+            rings.erase(std::remove_if(rings.begin(), rings.end(), isFinished), rings.end());
+        }
+        ++num_drains_;
+        done_cv_.notify_all();
+        if (is_stopping) {
+            return;
+        }
+    }
+}
+
+void BinaryLogger::drain(const std::vector<std::shared_ptr<RingBuffer>>& rings) {
+    std::string buffer;
+    for (const auto& ring : rings) {
+        ring->consume([&](const RecordHeader& header, const char* record) {
+            std::string_view args(record + sizeof(RecordHeader), header.size - sizeof(RecordHeader));
+            try {
+                const BinaryLogFormat& format = getFormat(header.format_id);
+                if (logger_) {
+                    sendMessage(*logger_, format, header.time, ring->getThreadId(), args);
+                    return;
+                }
+
+                // Write the definition of the format before its first record
+                if (header.format_id >= written_formats_.size()) {
+                    written_formats_.resize(header.format_id + 1, false);
+                }
+                if (!written_formats_[header.format_id]) {
+                    buffer += kFormatTag;
+                    appendValue(buffer, header.format_id);
+                    appendValue(buffer, static_cast<uint8_t>(format.level));
+                    appendValue(buffer, static_cast<int32_t>(format.line));
+                    appendValue(buffer, static_cast<uint32_t>(format.arg_types.size()));
+                    for (BinaryArgType type : format.arg_types) {
+                        buffer += static_cast<char>(type);
+                    }
+                    appendString(buffer, format.format);
+                    appendString(buffer, format.file);
+                    appendString(buffer, format.function);
+                    written_formats_[header.format_id] = true;
+                }
+                buffer += kRecordTag;
+                appendValue(buffer, static_cast<uint64_t>(ring->getThreadId()));
+                buffer.append(record, header.size);
+            } catch (const std::exception&) {
+                // A failing sink must not stop the draining; the record is lost
+                num_dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    if (file_ != nullptr && !buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), file_);
+    }
+}
+
+} // namespace icarus
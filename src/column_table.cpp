@@ -0,0 +1,414 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/column_table.cpp
+ * @brief Implementation of the class ColumnTable.
+ */
+#include "icarus/utils/column_table.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace icarus {
+
+namespace {
+
+using ColumnType = ColumnTable::ColumnType;
+
+/**
+ * @brief Checks whether a scalar is a YAML null value.
+ */
+bool isNullValue(std::string_view value) {
+    return value.empty() || value == "~" || value == "null" || value == "Null" || value == "NULL";
+}
+
+/**
+ * @brief Parses a YAML boolean value.
+ *
+ * @returns True if the value is a boolean, whose value is then stored in result.
+ */
+bool parseBool(std::string_view value, bool& result) {
+    if (value == "true" || value == "True" || value == "TRUE") {
+        result = true;
+        return true;
+    }
+    if (value == "false" || value == "False" || value == "FALSE") {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Parses a decimal integer value, e.g., "-42" or "+7".
+ *
+ * @returns True if the whole value is an integer in range, whose value is then stored in result.
+ */
+bool parseInt(std::string_view value, int64_t& result) {
+    // from_chars accepts no plus sign, which must not be followed by another sign
+    if (value.size() > 1 && value[0] == '+' && value[1] != '-') {
+        value.remove_prefix(1);
+    }
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    return error == std::errc() && end == value.data() + value.size() && !value.empty();
+}
+
+/**
+ * @brief Parses a floating-point value, including the YAML values .inf, -.inf and .nan.
+ *
+ * @returns True if the whole value is a float, whose value is then stored in result.
+ */
+bool parseFloat(std::string_view value, double& result) {
+    // YAML 1.2 core schema: infinity may be signed, NaN may not
+    if (value == ".nan" || value == ".NaN" || value == ".NAN") {
+        result = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+    if (value.size() > 1 && value[0] == '+' && value[1] != '-') {
+        value.remove_prefix(1);
+    }
+    if (value == ".inf" || value == ".Inf" || value == ".INF") {
+        result = std::numeric_limits<double>::infinity();
+        return true;
+    }
+    if (value == "-.inf" || value == "-.Inf" || value == "-.INF") {
+        result = -std::numeric_limits<double>::infinity();
+        return true;
+    }
+    // from_chars accepts "inf" and "nan", which are plain strings in YAML
+    if (value.empty() || value.find_first_of("iInN") != std::string_view::npos) {
+        return false;
+    }
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    return error == std::errc() && end == value.data() + value.size();
+}
+
+/**
+ * @brief Infers the narrowest type of a non-null scalar.
+ */
+ColumnType inferType(std::string_view value) {
+    bool bool_value;
+    int64_t int_value;
+    double float_value;
+    if (parseBool(value, bool_value)) {
+        return ColumnType::kBool;
+    }
+    if (parseInt(value, int_value)) {
+        return ColumnType::kInt;
+    }
+    if (parseFloat(value, float_value)) {
+        return ColumnType::kFloat;
+    }
+    return ColumnType::kString;
+}
+
+/**
+ * @brief Returns the common type of two cell or column types.
+ *
+ * Ints widen to floats; any other mix of types widens to strings.
+ */
+ColumnType widenType(ColumnType a, ColumnType b) {
+    if (a == b || b == ColumnType::kNull) {
+        return a;
+    }
+    if (a == ColumnType::kNull) {
+        return b;
+    }
+    if ((a == ColumnType::kInt && b == ColumnType::kFloat) ||
+            (a == ColumnType::kFloat && b == ColumnType::kInt)) {
+        return ColumnType::kFloat;
+    }
+    return ColumnType::kString;
+}
+
+/**
+ * @brief Formats a number with the shortest representation that reads back exactly.
+ */
+template<typename T>
+std::string formatNumber(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (std::isnan(value)) {
+            return ".nan";
+        }
+        if (std::isinf(value)) {
+            return (value > 0) ? ".inf" : "-.inf";
+        }
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    std::string str(buffer, result.ptr);
+
+    // Keep a marker of floats with integral values, so that they read back as floats
+    if constexpr (std::is_floating_point_v<T>) {
+        if (str.find_first_of(".e") == std::string::npos) {
+            str += ".0";
+        }
+    }
+    return str;
+}
+
+} // namespace
+
+// ================================
+// Column class
+// ================================
+
+size_t ColumnTable::Column::getNullCount() const {
+    return static_cast<size_t>(std::count(nulls_.begin(), nulls_.end(), uint8_t{1}));
+}
+
+const std::vector<uint8_t>& ColumnTable::Column::getBools() const {
+    checkType(ColumnType::kBool);
+    return bools_;
+}
+
+const std::vector<int64_t>& ColumnTable::Column::getInts() const {
+    checkType(ColumnType::kInt);
+    return ints_;
+}
+
+const std::vector<double>& ColumnTable::Column::getFloats() const {
+    checkType(ColumnType::kFloat);
+    return floats_;
+}
+
+const std::vector<std::string>& ColumnTable::Column::getStrings() const {
+    checkType(ColumnType::kString);
+    return strings_;
+}
+
+void ColumnTable::Column::checkType(ColumnType type) const {
+    if (type_ != type) {
+        throw std::runtime_error("Column '" + name_ + "' does not have the requested type.");
+    }
+}
+
+// End Column class ===============
+
+ColumnTable ColumnTable::fromDataNode(const DataNode& seq) {
+    if (!seq.isSeq()) {
+        throw std::runtime_error("Column table source must be a sequence.");
+    }
+
+    ColumnTable table;
+    table.num_rows_ = seq.getNumChildren();
+
+    // First pass: transpose the cells into views per column and infer the column types
+    std::vector<std::vector<std::string_view>> cells;
+    size_t row = 0;
+    for (const auto& item : seq) {
+        if (!item.isMap()) {
+            throw std::runtime_error("Row " + std::to_string(row) +
+                                     " of the column table is not a map.");
+        }
+        for (const auto& cell : item) {
+            if (cell.isMap() || cell.isSeq()) {
+                throw std::runtime_error("Cell '" + std::string(cell.getKeyView()) + "' of row " +
+                                         std::to_string(row) + " is not a scalar.");
+            }
+
+            std::string key(cell.getKeyView());
+            auto [it, is_new] = table.column_ids_.emplace(key, table.columns_.size());
+            if (is_new) {
+                table.columns_.emplace_back();
+                table.columns_.back().name_ = key;
+                cells.emplace_back(table.num_rows_);
+            }
+            Column& column = table.columns_[it->second];
+            std::string_view value = cell.getValView();
+            cells[it->second][row] = value;
+            if (!isNullValue(value)) {
+                column.type_ = widenType(column.type_, inferType(value));
+            }
+        }
+        ++row;
+    }
+
+    // Second pass: convert the cells of each column into one typed array
+    for (size_t col = 0; col < table.columns_.size(); ++col) {
+        Column& column = table.columns_[col];
+        const std::vector<std::string_view>& values = cells[col];
+        column.nulls_.assign(table.num_rows_, 0);
+        for (size_t i = 0; i < table.num_rows_; ++i) {
+            // Missing keys have a default (null) view
+            column.nulls_[i] = (values[i].data() == nullptr || isNullValue(values[i])) ? 1 : 0;
+        }
+
+        switch (column.type_) {
+            case ColumnType::kBool: {
+                column.bools_.assign(table.num_rows_, 0);
+                for (size_t i = 0; i < table.num_rows_; ++i) {
+                    bool value = false;
+                    if (!column.nulls_[i] && parseBool(values[i], value)) {
+                        column.bools_[i] = value ? 1 : 0;
+                    }
+                }
+                break;
+            }
+            case ColumnType::kInt:
+                column.ints_.assign(table.num_rows_, 0);
+                for (size_t i = 0; i < table.num_rows_; ++i) {
+                    if (!column.nulls_[i]) {
+                        parseInt(values[i], column.ints_[i]);
+                    }
+                }
+                break;
+            case ColumnType::kFloat:
+                column.floats_.assign(table.num_rows_, 0.0);
+                for (size_t i = 0; i < table.num_rows_; ++i) {
+                    if (!column.nulls_[i]) {
+                        parseFloat(values[i], column.floats_[i]);
+                    }
+                }
+                break;
+            case ColumnType::kString:
+                column.strings_.resize(table.num_rows_);
+                for (size_t i = 0; i < table.num_rows_; ++i) {
+                    if (!column.nulls_[i]) {
+                        column.strings_[i].assign(values[i]);
+                    }
+                }
+                break;
+            case ColumnType::kNull:
+                break;
+        }
+    }
+
+    return table;
+}
+
+DataNode ColumnTable::toDataNode() const {
+    // Format each column once, so that rows are only assembled from strings
+    std::vector<std::vector<std::string>> formatted(columns_.size());
+    for (size_t col = 0; col < columns_.size(); ++col) {
+        const Column& column = columns_[col];
+        std::vector<std::string>& values = formatted[col];
+        values.resize(num_rows_, "~");
+        for (size_t i = 0; i < num_rows_; ++i) {
+            if (column.nulls_[i]) {
+                continue;
+            }
+            switch (column.type_) {
+                case ColumnType::kBool:
+                    values[i] = column.bools_[i] ? "true" : "false";
+                    break;
+                case ColumnType::kInt:
+                    values[i] = formatNumber(column.ints_[i]);
+                    break;
+                case ColumnType::kFloat:
+                    values[i] = formatNumber(column.floats_[i]);
+                    break;
+                case ColumnType::kString:
+                    values[i] = column.strings_[i];
+                    break;
+                case ColumnType::kNull:
+                    break;
+            }
+        }
+    }
+
+    // Column names are unique, so cells are appended without searching the row for the key
+    DataNode seq(DataNode::Type::kSeq);
+    for (size_t i = 0; i < num_rows_; ++i) {
+        DataNode row = seq.append();
+        row.setType(DataNode::Type::kMap);
+        for (size_t col = 0; col < columns_.size(); ++col) {
+            row.append(columns_[col].name_) << formatted[col][i];
+        }
+    }
+    return seq;
+}
+
+void ColumnTable::addColumn(const std::string& name, const std::vector<bool>& values,
+                            std::vector<uint8_t> nulls) {
+    Column column;
+    column.name_ = name;
+    column.type_ = ColumnType::kBool;
+    column.bools_.assign(values.begin(), values.end());
+    column.nulls_ = std::move(nulls);
+    appendColumn(std::move(column), values.size());
+}
+
+void ColumnTable::addColumn(const std::string& name, std::vector<int64_t> values,
+                            std::vector<uint8_t> nulls) {
+    Column column;
+    column.name_ = name;
+    column.type_ = ColumnType::kInt;
+    size_t num_values = values.size();
+    column.ints_ = std::move(values);
+    column.nulls_ = std::move(nulls);
+    appendColumn(std::move(column), num_values);
+}
+
+void ColumnTable::addColumn(const std::string& name, std::vector<double> values,
+                            std::vector<uint8_t> nulls) {
+    Column column;
+    column.name_ = name;
+    column.type_ = ColumnType::kFloat;
+    size_t num_values = values.size();
+    column.floats_ = std::move(values);
+    column.nulls_ = std::move(nulls);
+    appendColumn(std::move(column), num_values);
+}
+
+void ColumnTable::addColumn(const std::string& name, std::vector<std::string> values,
+                            std::vector<uint8_t> nulls) {
+    Column column;
+    column.name_ = name;
+    column.type_ = ColumnType::kString;
+    size_t num_values = values.size();
+    column.strings_ = std::move(values);
+    column.nulls_ = std::move(nulls);
+    appendColumn(std::move(column), num_values);
+}
+
+size_t ColumnTable::getNumRows() const {
+    return num_rows_;
+}
+
+size_t ColumnTable::getNumColumns() const {
+    return columns_.size();
+}
+
+bool ColumnTable::hasColumn(const std::string& name) const {
+    return column_ids_.count(name) > 0;
+}
+
+const ColumnTable::Column& ColumnTable::getColumn(size_t index) const {
+    return columns_[index];
+}
+
+const ColumnTable::Column& ColumnTable::getColumn(const std::string& name) const {
+    auto it = column_ids_.find(name);
+    if (it == column_ids_.end()) {
+        throw std::runtime_error("Column not found: " + name);
+    }
+    return columns_[it->second];
+}
+
+void ColumnTable::appendColumn(Column column, size_t num_values) {
+    if (columns_.empty()) {
+        num_rows_ = num_values;
+    }
+    if (num_values != num_rows_) {
+        throw std::runtime_error("Column '" + column.name_ + "' has " + std::to_string(num_values) +
+                                 " values instead of " + std::to_string(num_rows_) + ".");
+    }
+    if (column.nulls_.empty()) {
+        column.nulls_.assign(num_values, 0);
+    } else if (column.nulls_.size() != num_values) {
+        throw std::runtime_error("Null mask of column '" + column.name_ + "' has the wrong size.");
+    }
+    if (!column_ids_.emplace(column.name_, columns_.size()).second) {
+        throw std::runtime_error("Column already exists: " + column.name_);
+    }
+    columns_.push_back(std::move(column));
+}
+
+} // namespace icarus
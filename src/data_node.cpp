@@ -7,13 +7,552 @@
  */
 #include "icarus/utils/data_node.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <utility>
 
+#include "icarus/utils/data_node_registry.h"
+#include "icarus/utils/symbol_pool.h"
 #include "icarus/utils/system_ops.h"
+#include "icarus/utils/thread_pool.h"
+
+namespace fs = std::filesystem;
 
 namespace icarus {
 
+namespace {
+
+/// Tag of values to be replaced by the content of another file.
+constexpr const char* kIncludeTag = "!include";
+
+/**
+ * @brief Parsed included file and the nodes of its own !include values.
+ */
+struct IncludedFile {
+    /// Tree of the file (resolved in place once all its includes are resolved).
+    std::shared_ptr<ryml::Tree> tree;
+    /// Node IDs of the !include values and the normalized paths they refer to.
+    std::vector<std::pair<size_t, std::string>> includes;
+    /// Flag whether the includes of the file have been spliced into its tree.
+    bool is_resolved = false;
+};
+
+/**
+ * @brief Collects the !include values of a tree with their paths normalized relative to a file.
+ */
+std::vector<std::pair<size_t, std::string>> findIncludes(const ryml::Tree& tree,
+                                                         const std::string& file_path) {
+    std::vector<std::pair<size_t, std::string>> includes;
+    fs::path dir_path = fs::path(file_path).parent_path();
+
+    std::vector<size_t> stack = {tree.root_id()};
+    while (!stack.empty()) {
+        size_t id = stack.back();
+        stack.pop_back();
+
+        if (tree.has_val(id) && tree.has_val_tag(id) && tree.val_tag(id) == kIncludeTag) {
+            const ryml::csubstr& target = tree.val(id);
+            fs::path abs_path = utils::getAbsPath(dir_path, std::string(target.str, target.len));
+            includes.emplace_back(id, abs_path.lexically_normal().string());
+        }
+        for (size_t child_id = tree.first_child(id); child_id != ryml::NONE;
+             child_id = tree.next_sibling(child_id)) {
+            stack.push_back(child_id);
+        }
+    }
+    return includes;
+}
+
+/**
+ * @brief Returns the number of bytes of all keys and values of a subtree.
+ */
+size_t getSubtreeStrBytes(const ryml::Tree& tree, size_t node_id) {
+    size_t num_bytes = 0;
+    if (tree.has_key(node_id)) {
+        num_bytes += tree.key(node_id).len;
+    }
+    if (tree.has_val(node_id)) {
+        num_bytes += tree.val(node_id).len;
+    }
+    if (tree.has_key_tag(node_id)) {
+        num_bytes += tree.key_tag(node_id).len;
+    }
+    if (tree.has_val_tag(node_id)) {
+        num_bytes += tree.val_tag(node_id).len;
+    }
+    if (tree.has_key_anchor(node_id) || tree.is_key_ref(node_id)) {
+        num_bytes += tree.key_anchor(node_id).len;
+    }
+    if (tree.has_val_anchor(node_id) || tree.is_val_ref(node_id)) {
+        num_bytes += tree.val_anchor(node_id).len;
+    }
+    for (size_t child_id = tree.first_child(node_id); child_id != ryml::NONE;
+         child_id = tree.next_sibling(child_id)) {
+        num_bytes += getSubtreeStrBytes(tree, child_id);
+    }
+    return num_bytes;
+}
+
+/**
+ * @brief Copies the tags, anchors and alias references of a source node into a destination node.
+ *
+ * The key properties are only copied if the source node has a key, i.e., not for the
+ * root of an included tree, whose key is the one of the !include node.
+ */
+void copyNodeProperties(ryml::Tree& dst, size_t dst_id, const ryml::Tree& src, size_t src_id) {
+    if (src.has_key_tag(src_id)) {
+        dst.set_key_tag(dst_id, dst.copy_to_arena(src.key_tag(src_id)));
+    }
+    if (src.has_key_anchor(src_id)) {
+        dst.set_key_anchor(dst_id, dst.copy_to_arena(src.key_anchor(src_id)));
+    } else if (src.is_key_ref(src_id)) {
+        dst.set_key_ref(dst_id, dst.copy_to_arena(src.key_ref(src_id)));
+    }
+    if (src.has_val_tag(src_id)) {
+        dst.set_val_tag(dst_id, dst.copy_to_arena(src.val_tag(src_id)));
+    }
+    if (src.has_val_anchor(src_id)) {
+        dst.set_val_anchor(dst_id, dst.copy_to_arena(src.val_anchor(src_id)));
+    } else if (src.is_val_ref(src_id)) {
+        dst.set_val_ref(dst_id, dst.copy_to_arena(src.val_ref(src_id)));
+    }
+}
+
+/**
+ * @brief Copies the contents of a source node into a destination node, keeping its key.
+ *
+ * Tags, anchors, aliases and quoting are preserved. Strings are copied into the arena of
+ * the destination tree, which must have enough free capacity so that it is not relocated
+ * during the copy.
+ */
+void copyNodeContents(ryml::Tree& dst, size_t dst_id, const ryml::Tree& src, size_t src_id) {
+    bool has_key = dst.has_key(dst_id);
+    ryml::csubstr key = has_key ? dst.key(dst_id) : ryml::csubstr();
+    ryml::type_bits key_flags = (has_key && dst.is_key_quoted(dst_id)) ? ryml::type_bits(ryml::KEYQUO) : 0;
+
+    if (src.is_map(src_id)) {
+        has_key ? dst.to_map(dst_id, key, key_flags) : dst.to_map(dst_id);
+    } else if (src.is_seq(src_id)) {
+        has_key ? dst.to_seq(dst_id, key, key_flags) : dst.to_seq(dst_id);
+    } else {
+        ryml::csubstr val = dst.copy_to_arena(src.val(src_id));
+        ryml::type_bits val_flags = src.is_val_quoted(src_id) ? ryml::type_bits(ryml::VALQUO) : 0;
+        has_key ? dst.to_keyval(dst_id, key, val, key_flags | val_flags)
+                : dst.to_val(dst_id, val, val_flags);
+        copyNodeProperties(dst, dst_id, src, src_id);
+        return;
+    }
+    copyNodeProperties(dst, dst_id, src, src_id);
+
+    for (size_t src_child = src.first_child(src_id); src_child != ryml::NONE;
+         src_child = src.next_sibling(src_child)) {
+        size_t dst_child = dst.append_child(dst_id);
+        if (src.has_key(src_child)) {
+            // Set the key first, the contents are then copied around it
+            ryml::csubstr child_key = dst.copy_to_arena(src.key(src_child));
+            dst.to_keyval(dst_child, child_key, ryml::csubstr(),
+                          src.is_key_quoted(src_child) ? ryml::type_bits(ryml::KEYQUO) : 0);
+        }
+        copyNodeContents(dst, dst_child, src, src_child);
+    }
+}
+
+/**
+ * @brief Replaces an !include value node by the root contents of an included tree.
+ */
+void spliceTree(ryml::Tree& dst, size_t dst_id, const ryml::Tree& src) {
+    size_t src_root = src.root_id();
+    if (src.is_stream(src_root) && src.first_child(src_root) != ryml::NONE) {
+        src_root = src.first_child(src_root);  // First document of a multi-document file
+    }
+
+    // Reserve the arena upfront so that existing strings are never relocated while copying
+    dst.reserve_arena(dst.arena_size() + getSubtreeStrBytes(src, src_root));
+    copyNodeContents(dst, dst_id, src, src_root);
+}
+
+/**
+ * @brief Throws if the include graph reachable from a file contains a cycle.
+ */
+void checkIncludeCycles(const std::map<std::string, IncludedFile>& files,
+                        const std::string& file_path,
+                        std::map<std::string, int>& states,
+                        std::vector<std::string>& chain) {
+    int& state = states[file_path];
+    if (state == 2) {
+        return;  // Already checked
+    }
+    if (state == 1) {
+        std::string cycle;
+        auto it = std::find(chain.begin(), chain.end(), file_path);
+        for (; it != chain.end(); ++it) {
+            cycle += *it + " -> ";
+        }
+        throw std::runtime_error("Include cycle detected: " + cycle + file_path);
+    }
+
+    state = 1;
+    chain.push_back(file_path);
+    for (const auto& include : files.at(file_path).includes) {
+        checkIncludeCycles(files, include.second, states, chain);
+    }
+    chain.pop_back();
+    states[file_path] = 2;
+}
+
+/**
+ * @brief Splices the (recursively resolved) included files into the tree of a file.
+ */
+void resolveFile(std::map<std::string, IncludedFile>& files, const std::string& file_path) {
+    IncludedFile& file = files.at(file_path);
+    if (file.is_resolved) {
+        return;
+    }
+    for (const auto& [node_id, include_path] : file.includes) {
+        resolveFile(files, include_path);
+        spliceTree(*file.tree, node_id, *files.at(include_path).tree);
+    }
+    file.is_resolved = true;
+}
+
+/**
+ * @brief Checks whether a scalar is a JSON number or literal and can be emitted unquoted.
+ *
+ * @param scalar Scalar to check.
+ * @returns True if the scalar is a JSON number, `true`, `false` or `null`.
+ */
+bool isJsonLiteral(std::string_view scalar) {
+    if (scalar == "true" || scalar == "false" || scalar == "null") {
+        return true;
+    }
+
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t pos = 0;
+    auto isDigit = [&scalar](size_t i) {
+        return i < scalar.size() && scalar[i] >= '0' && scalar[i] <= '9';
+    };
+    auto skipDigits = [&]() {
+        size_t start = pos;
+        while (isDigit(pos)) {
+            ++pos;
+        }
+        return pos > start;
+    };
+    if (pos < scalar.size() && scalar[pos] == '-') {
+        ++pos;
+    }
+    if (isDigit(pos) && scalar[pos] == '0') {
+        ++pos;
+    } else if (!skipDigits()) {
+        return false;
+    }
+    if (pos < scalar.size() && scalar[pos] == '.') {
+        ++pos;
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    if (pos < scalar.size() && (scalar[pos] == 'e' || scalar[pos] == 'E')) {
+        ++pos;
+        if (pos < scalar.size() && (scalar[pos] == '+' || scalar[pos] == '-')) {
+            ++pos;
+        }
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    return pos == scalar.size();
+}
+
+/**
+ * @brief Checks whether a plain YAML scalar is null according to the YAML 1.2 core schema.
+ *
+ * @param scalar Scalar to check.
+ * @returns True if the scalar is empty, `~`, `null`, `Null` or `NULL`.
+ */
+bool isYamlNull(std::string_view scalar) {
+    return scalar.empty() || scalar == "~" || scalar == "null" || scalar == "Null" ||
+           scalar == "NULL";
+}
+
+/**
+ * @brief Checks whether a plain YAML scalar must be quoted to be read back as the same string.
+ *
+ * @param scalar Scalar to check.
+ * @param is_flow Flag whether the scalar is emitted in a flow container.
+ * @returns True if the scalar must be quoted.
+ */
+bool needsYamlQuotes(std::string_view scalar, bool is_flow) {
+    if (scalar.empty() || scalar.front() == ' ' || scalar.back() == ' ' || scalar.back() == ':') {
+        return true;
+    }
+    char first = scalar.front();
+    if (std::string_view("#,[]{}&*!|>'\"%@`").find(first) != std::string_view::npos) {
+        return true;
+    }
+    if ((first == '-' || first == '?' || first == ':') && (scalar.size() == 1 || scalar[1] == ' ')) {
+        return true;
+    }
+    if (scalar.find(": ") != std::string_view::npos || scalar.find(" #") != std::string_view::npos) {
+        return true;
+    }
+    for (char c : scalar) {
+        bool is_flow_indicator = is_flow && std::string_view(",[]{}").find(c) != std::string_view::npos;
+        if (static_cast<unsigned char>(c) < 0x20 || is_flow_indicator) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Streaming emitter of a data node into a sink, see DataNode::emitTo.
+ *
+ * Lines are separated, not terminated, by newlines, so the output has no trailing newline.
+ */
+class StreamEmitter {
+public:
+    StreamEmitter(const ryml::Tree& tree, const DataNode::EmitSink& sink,
+                  const DataNode::EmitOptions& options)
+            : tree_(tree), sink_(sink), options_(options),
+              is_json_(options.format == DataNode::Format::kJson) {}
+
+    /**
+     * @brief Emits a node and its subtree.
+     *
+     * @param id ID of the node.
+     */
+    void emitNode(size_t id) {
+        if (!tree_.is_container(id)) {
+            writeScalar(getVal(id), tree_.is_val_quoted(id), false);
+        } else if (is_json_ || options_.is_compact || isCollapsed(id, 0)) {
+            emitFlow(id, 0, 0);
+        } else {
+            emitBlockChildren(id, 1, 0, false);
+        }
+    }
+
+private:
+    /// Spaces written for indentation.
+    static constexpr std::string_view kSpaces = "                                ";
+
+    void write(std::string_view str) {
+        sink_(str);
+    }
+
+    void writeIndent(size_t indent) {
+        for (; indent > kSpaces.size(); indent -= kSpaces.size()) {
+            write(kSpaces);
+        }
+        write(kSpaces.substr(0, indent));
+    }
+
+    void startLine(size_t indent) {
+        if (!is_first_line_) {
+            write("\n");
+        }
+        is_first_line_ = false;
+        writeIndent(indent);
+    }
+
+    static std::string_view toView(ryml::csubstr str) {
+        return (str.str == nullptr) ? std::string_view() : std::string_view(str.str, str.len);
+    }
+
+    std::string_view getVal(size_t id) const {
+        return tree_.has_val(id) ? toView(tree_.val(id)) : std::string_view();
+    }
+
+    /**
+     * @brief Checks whether a node is an empty container or a container beyond the depth limit.
+     */
+    bool isCollapsed(size_t id, size_t level) const {
+        return tree_.is_container(id) &&
+               (level >= options_.max_depth || tree_.num_children(id) == 0);
+    }
+
+    void writeCollapsed(size_t id) {
+        bool is_map = tree_.is_map(id);
+        if (tree_.num_children(id) == 0) {
+            write(is_map ? "{}" : "[]");
+        } else {
+            write(is_map ? "{...}" : "[...]");
+        }
+    }
+
+    void writeDoubleQuoted(std::string_view str) {
+        write("\"");
+        size_t start = 0;
+        for (size_t i = 0; i < str.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(str[i]);
+            if (c != '"' && c != '\\' && c >= 0x20) {
+                continue;
+            }
+            write(str.substr(start, i - start));
+            start = i + 1;
+            switch (c) {
+                case '"': write("\\\""); break;
+                case '\\': write("\\\\"); break;
+                case '\n': write("\\n"); break;
+                case '\r': write("\\r"); break;
+                case '\t': write("\\t"); break;
+                default: {
+                    static constexpr char kHex[] = "0123456789abcdef";
+                    char escaped[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                    write(std::string_view(escaped, sizeof(escaped)));
+                }
+            }
+        }
+        write(str.substr(start));
+        write("\"");
+    }
+
+    void writeScalar(std::string_view scalar, bool is_quoted, bool is_key) {
+        if (is_json_) {
+            if (!is_key && (scalar.data() == nullptr || (!is_quoted && isYamlNull(scalar)))) {
+                write("null");
+            } else if (!is_key && !is_quoted && isJsonLiteral(scalar)) {
+                write(scalar);
+            } else {
+                writeDoubleQuoted(scalar);
+            }
+            return;
+        }
+
+        if (scalar.data() == nullptr) {
+            write("~");
+            return;
+        }
+        // Quoted numbers and literals must stay strings
+        bool is_flow = options_.is_compact;
+        bool is_literal = is_quoted && (isJsonLiteral(scalar) || scalar == "~");
+        if (!is_literal && !needsYamlQuotes(scalar, is_flow)) {
+            write(scalar);
+            return;
+        }
+        bool has_control = std::any_of(scalar.begin(), scalar.end(), [](char c) {
+            return static_cast<unsigned char>(c) < 0x20;
+        });
+        if (has_control) {
+            writeDoubleQuoted(scalar);
+            return;
+        }
+        write("'");
+        size_t start = 0;
+        for (size_t pos = scalar.find('\''); pos != std::string_view::npos;
+             pos = scalar.find('\'', start)) {
+            write(scalar.substr(start, pos + 1 - start));
+            write("'");
+            start = pos + 1;
+        }
+        write(scalar.substr(start));
+        write("'");
+    }
+
+    void writeKey(size_t id) {
+        writeScalar(toView(tree_.key(id)), false, true);
+        write(": ");
+    }
+
+    /**
+     * @brief Emits the children of a container in YAML block style.
+     *
+     * @param id ID of the container.
+     * @param level Nesting level of the children relative to the emitted node.
+     * @param indent Indentation of the children.
+     * @param is_inline Flag whether the first child continues the current line (after "- ").
+     */
+    void emitBlockChildren(size_t id, size_t level, size_t indent, bool is_inline) {
+        bool is_map = tree_.is_map(id);
+        for (size_t child = tree_.first_child(id); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            if (is_inline) {
+                is_inline = false;
+            } else {
+                startLine(indent);
+            }
+
+            if (is_map) {
+                writeScalar(toView(tree_.key(child)), false, true);
+                write(":");
+            } else {
+                write("-");
+            }
+
+            if (!tree_.is_container(child)) {
+                write(" ");
+                writeScalar(getVal(child), tree_.is_val_quoted(child), false);
+            } else if (isCollapsed(child, level)) {
+                write(" ");
+                writeCollapsed(child);
+            } else if (is_map) {
+                emitBlockChildren(child, level + 1, indent + 2, false);
+            } else {
+                write(" ");
+                emitBlockChildren(child, level + 1, indent + 2, true);
+            }
+        }
+    }
+
+    /**
+     * @brief Emits a node in flow style (YAML) or as JSON, on one or multiple lines.
+     *
+     * @param id ID of the node.
+     * @param level Nesting level of the node relative to the emitted node.
+     * @param indent Indentation of the node for multi-line JSON.
+     */
+    void emitFlow(size_t id, size_t level, size_t indent) {
+        if (!tree_.is_container(id)) {
+            writeScalar(getVal(id), tree_.is_val_quoted(id), false);
+            return;
+        }
+        if (isCollapsed(id, level)) {
+            writeCollapsed(id);
+            return;
+        }
+
+        bool is_map = tree_.is_map(id);
+        bool is_multiline = !options_.is_compact;
+        write(is_map ? "{" : "[");
+        for (size_t child = tree_.first_child(id); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            if (child != tree_.first_child(id)) {
+                write(is_multiline ? "," : ", ");
+            }
+            if (is_multiline) {
+                write("\n");
+                writeIndent(indent + 2);
+            }
+            if (is_map) {
+                writeKey(child);
+            }
+            emitFlow(child, level + 1, indent + 2);
+        }
+        if (is_multiline) {
+            write("\n");
+            writeIndent(indent);
+        }
+        write(is_map ? "}" : "]");
+    }
+
+    /// Tree of the emitted node.
+    const ryml::Tree& tree_;
+    /// Sink receiving the output.
+    const DataNode::EmitSink& sink_;
+    /// Options of the emission.
+    const DataNode::EmitOptions& options_;
+    /// Flag whether the output is JSON.
+    bool is_json_;
+    /// Flag whether no line has been started yet.
+    bool is_first_line_ = true;
+};
+
+} // namespace
+
 // ================================
 // NodeIterator class
 // ================================
@@ -70,6 +609,12 @@ void DataNode::parseFromStr(const std::string& content) {
 void DataNode::parseFromFile(const std::string& file_path) {
 	std::string content = utils::getFileContent(file_path);
 	parseFromStr(content);
+    resolveIncludes(file_path);
+
+    DataNodeRegistry& registry = DataNodeRegistry::getInstance();
+    if (registry.isEnabled()) {
+        registry.record(file_path, getStats());
+    }
 }
 
 DataNode::NodeIterator DataNode::begin() const {
@@ -142,6 +687,30 @@ DataNode DataNode::operator[](size_t index) {
     return DataNode(tree_, tree_->child(node_id_, index));
 }
 
+DataNode DataNode::append() {
+    if (!isSeq()) {
+        throw std::runtime_error("Node is not a sequence.");
+    }
+    return DataNode(tree_, tree_->append_child(node_id_));
+}
+
+DataNode DataNode::append(const std::string& key) {
+    if (!isMap()) {
+        throw std::runtime_error("Node is not a map.");
+    }
+    size_t child_id = tree_->append_child(node_id_);
+    tree_->to_keyval(child_id, tree_->copy_to_arena(ryml::to_csubstr(key)), ryml::csubstr());
+    return DataNode(tree_, child_id);
+}
+
+void DataNode::setType(Type type) {
+    if (type == Type::kMap) {
+        tree_->ref(node_id_) |= ryml::MAP;
+    } else if (type == Type::kSeq) {
+        tree_->ref(node_id_) |= ryml::SEQ;
+    }
+}
+
 bool DataNode::isValid() const {
     return (tree_ != nullptr) && (node_id_ != ryml::NONE);
 }
@@ -171,6 +740,26 @@ std::string DataNode::getKey() const {
     }
 }
 
+std::string_view DataNode::getKeyView() const {
+    if (!tree_->has_key(node_id_)) {
+        return {};
+    }
+    const ryml::csubstr& key = tree_->key(node_id_);
+    return std::string_view(key.str, key.len);
+}
+
+std::string_view DataNode::getValView() const {
+    if (!tree_->has_val(node_id_)) {
+        return {};
+    }
+    const ryml::csubstr& val = tree_->val(node_id_);
+    return std::string_view(val.str, val.len);
+}
+
+utils::Symbol DataNode::getKeySymbol() const {
+    return utils::SymbolPool::getGlobal().intern(getKeyView());
+}
+
 DataNode DataNode::first() const {
     return DataNode(tree_, tree_->first_child(node_id_));
 }
@@ -183,6 +772,51 @@ size_t DataNode::getNumChildren() const {
 	return tree_->num_children(node_id_);
 }
 
+DataNode::Stats DataNode::getStats() const {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid YAML tree");
+    }
+
+    Stats stats;
+    stats.node_capacity = tree_->capacity();
+    stats.node_bytes = tree_->capacity() * sizeof(ryml::NodeData);
+    stats.arena_used = tree_->arena_size();
+    stats.arena_reserved = tree_->arena_capacity();
+
+    // Depth-first traversal with an explicit stack of (node ID, depth) pairs
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(node_id_, 0);
+    while (!stack.empty()) {
+        auto [id, depth] = stack.back();
+        stack.pop_back();
+
+        ++stats.num_nodes;
+        stats.max_depth = std::max(stats.max_depth, depth);
+
+        size_t num_children = 0;
+        for (size_t child_id = tree_->first_child(id); child_id != ryml::NONE;
+             child_id = tree_->next_sibling(child_id)) {
+            stack.emplace_back(child_id, depth + 1);
+            ++num_children;
+        }
+
+        if (tree_->is_map(id)) {
+            stats.max_map_width = std::max(stats.max_map_width, num_children);
+        } else if (tree_->is_seq(id)) {
+            stats.max_seq_width = std::max(stats.max_seq_width, num_children);
+        }
+    }
+
+    return stats;
+}
+
+void DataNode::reserve(size_t node_capacity, size_t arena_capacity) {
+    tree_->reserve(node_capacity);
+    if (arena_capacity > 0) {
+        tree_->reserve_arena(arena_capacity);
+    }
+}
+
 void DataNode::print(Format format) const {
     std::cout << "============================\n";
 
@@ -199,18 +833,29 @@ void DataNode::print(Format format) const {
     std::cout << "============================\n" << std::endl;
 }
 
-void DataNode::writeToFile(const std::string& output_file_path, Format format) const {
-    std::ofstream file(output_file_path);
-    if (file) {
-        if (format == Format::kYaml) {
-            file << emitYaml();
-        } else {
-            file << emitJson();
-        }
-        file.close();
-    } else {
-        throw std::runtime_error("Cannot open file for writing: " + output_file_path);
+std::string DataNode::emitStr(Format format, size_t num_threads) const {
+    std::vector<std::string> chunks = emitChunks(format, num_threads);
+    if (chunks.size() == 1) {
+        return std::move(chunks[0]);
     }
+
+    size_t total_size = 0;
+    for (const auto& chunk : chunks) {
+        total_size += chunk.size();
+    }
+    std::string content;
+    content.reserve(total_size);
+    for (const auto& chunk : chunks) {
+        content += chunk;
+    }
+    return content;
+}
+
+bool DataNode::writeToFile(const std::string& output_file_path, Format format,
+                           size_t num_threads, utils::WriteMode mode) const {
+    std::vector<std::string> chunks = emitChunks(format, num_threads);
+    std::vector<std::string_view> buffers(chunks.begin(), chunks.end());
+    return utils::writeBuffersToFile(buffers, output_file_path, mode);
 }
 
 DataNode DataNode::getMapFromSeq(const std::string& key) const {
@@ -252,11 +897,107 @@ std::vector<std::string> DataNode::getSeqStrings() {
     return seq_strings;
 }
 
+std::vector<utils::Symbol> DataNode::getSeqSymbols() const {
+    if (!isSeq()) {
+        throw std::runtime_error("The provided YAML node is not a sequence.");
+    }
+
+    std::vector<utils::Symbol> seq_symbols;
+    seq_symbols.reserve(tree_->num_children(node_id_));
+    utils::SymbolPool& pool = utils::SymbolPool::getGlobal();
+    for (size_t child_id = tree_->first_child(node_id_); child_id != ryml::NONE;
+         child_id = tree_->next_sibling(child_id)) {
+        const ryml::csubstr& val = tree_->val(child_id);
+        seq_symbols.push_back(pool.intern(std::string_view(val.str, val.len)));
+    }
+    return seq_symbols;
+}
+
 DataNode::DataNode(std::shared_ptr<ryml::Tree> tree, size_t node_id)
         : tree_(tree),
 	      node_id_(node_id) {}
 
 
+void DataNode::resolveIncludes(const std::string& file_path) {
+    std::string root_path = fs::absolute(file_path).lexically_normal().string();
+    std::map<std::string, IncludedFile> files;
+    IncludedFile& root_file = files[root_path];
+    root_file.tree = tree_;
+    root_file.includes = findIncludes(*tree_, root_path);
+    if (root_file.includes.empty()) {
+        return;
+    }
+
+    // Load the include graph level by level, parsing the new files of a level in parallel.
+    // Each distinct file is parsed only once.
+    std::vector<std::string> level = {root_path};
+    while (!level.empty()) {
+        std::vector<std::string> new_paths;
+        for (const auto& path : level) {
+            for (const auto& include : files.at(path).includes) {
+                if (files.count(include.second) == 0 &&
+                    std::find(new_paths.begin(), new_paths.end(), include.second) == new_paths.end()) {
+                    new_paths.push_back(include.second);
+                }
+            }
+        }
+
+        auto load_file = [](const std::string& path) {
+            IncludedFile included;
+            included.tree = std::make_shared<ryml::Tree>();
+            std::string content = utils::getFileContent(path);
+            try {
+                ryml::parse_in_arena(ryml::to_csubstr(content), *included.tree);
+            }
+            catch (const std::exception& e) {
+                throw std::runtime_error("Parsing error in " + path + ": " + e.what());
+            }
+            included.includes = findIncludes(*included.tree, path);
+            return included;
+        };
+
+        // Blocking on the shared pool from one of its workers may deadlock, so load inline there
+        utils::ThreadPool& pool = utils::ThreadPool::getShared();
+        if (pool.isWorkerThread()) {
+            for (const auto& path : new_paths) {
+                files[path] = load_file(path);
+            }
+        } else {
+            std::vector<std::future<IncludedFile>> loads;
+            loads.reserve(new_paths.size());
+            for (const auto& path : new_paths) {
+                loads.push_back(pool.submit([load_file, path]() { return load_file(path); }));
+            }
+            for (size_t i = 0; i < new_paths.size(); ++i) {
+                files[new_paths[i]] = loads[i].get();
+            }
+        }
+        level = std::move(new_paths);
+    }
+
+    std::map<std::string, int> states;
+    std::vector<std::string> chain;
+    checkIncludeCycles(files, root_path, states, chain);
+
+    resolveFile(files, root_path);
+}
+
+void DataNode::emitTo(const EmitSink& sink, const EmitOptions& options) const {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid YAML tree");
+    }
+    // The Ryml emitter is used whenever it supports the options, so that both agree
+    if (!options.is_compact && options.max_depth == std::numeric_limits<size_t>::max()) {
+        std::string content = (options.format == Format::kYaml)
+                                  ? ryml::emitrs_yaml<std::string>(*tree_, node_id_)
+                                  : ryml::emitrs_json<std::string>(*tree_, node_id_);
+        std::string_view view(content);
+        sink(view.substr(0, view.find_last_not_of('\n') + 1));
+        return;
+    }
+    StreamEmitter(*tree_, sink, options).emitNode(node_id_);
+}
+
 std::string DataNode::emitYaml() const {
 	if (!isValid()) {
 		throw std::runtime_error("Invalid YAML tree");
@@ -271,6 +1012,93 @@ std::string DataNode::emitJson() const {
 	return ryml::emitrs_json<std::string>(*tree_, node_id_);
 }
 
+std::vector<std::string> DataNode::emitChunks(Format format, size_t num_threads) const {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid YAML tree");
+    }
+
+    auto emitNode = [format](const ryml::Tree& tree, size_t id) {
+        return (format == Format::kYaml) ? ryml::emitrs_yaml<std::string>(tree, id)
+                                         : ryml::emitrs_json<std::string>(tree, id);
+    };
+
+    utils::ThreadPool& pool = utils::ThreadPool::getShared();
+    if (num_threads == 0) {
+        num_threads = pool.getNumThreads();
+    }
+    if (pool.isWorkerThread()) {
+        num_threads = 1;  // Blocking on the shared pool from one of its workers may deadlock
+    }
+
+    // Only a plain root container is emitted as the plain concatenation of its children
+    size_t num_children = tree_->num_children(node_id_);
+    bool is_container = tree_->is_map(node_id_) || tree_->is_seq(node_id_);
+    bool is_splittable = num_threads > 1 && num_children >= kMinParallelEmitChildren &&
+                         is_container && tree_->is_root(node_id_) &&
+                         !tree_->is_stream(node_id_) && !tree_->is_doc(node_id_) &&
+                         !tree_->has_val_tag(node_id_) && !tree_->has_val_anchor(node_id_);
+    if (!is_splittable) {
+        return {emitNode(*tree_, node_id_)};
+    }
+
+    // The tasks own everything they use, as they may still run when a failed chunk
+    // rethrows its exception below
+    auto child_ids = std::make_shared<std::vector<size_t>>();
+    child_ids->reserve(num_children);
+    for (size_t child_id = tree_->first_child(node_id_); child_id != ryml::NONE;
+         child_id = tree_->next_sibling(child_id)) {
+        child_ids->push_back(child_id);
+    }
+
+    // Several chunks per thread to balance children of different sizes
+    size_t num_chunks = std::min(num_children, num_threads * 4);
+    bool is_map = tree_->is_map(node_id_);
+    std::vector<std::future<std::string>> futures;
+    futures.reserve(num_chunks);
+
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        size_t first = chunk * num_children / num_chunks;
+        size_t last = (chunk + 1) * num_children / num_chunks;
+
+        futures.push_back(pool.submit([tree = tree_, child_ids, emitNode, is_map, first, last]() {
+            // Temporary tree with a copy of the nodes of the chunk; its strings still
+            // point into the arena of the source tree
+            ryml::Tree chunk_tree;
+            size_t root_id = chunk_tree.root_id();
+            is_map ? chunk_tree.to_map(root_id) : chunk_tree.to_seq(root_id);
+
+            size_t after = ryml::NONE;
+            for (size_t i = first; i < last; ++i) {
+                after = chunk_tree.duplicate(tree.get(), (*child_ids)[i], root_id, after);
+            }
+            return emitNode(chunk_tree, root_id);
+        }));
+    }
+
+    std::vector<std::string> chunks;
+    chunks.reserve(num_chunks);
+    for (auto& future : futures) {
+        chunks.push_back(future.get());
+    }
+
+    // YAML block containers are the plain concatenation of their children, whereas
+    // JSON chunks are joined by removing the inner brackets and adding separators
+    if (format == Format::kJson) {
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            std::string& chunk = chunks[i];
+            if (i + 1 < chunks.size()) {
+                chunk.erase(chunk.find_last_not_of(" \n"));
+                chunk += ',';
+            }
+            if (i > 0) {
+                chunk.erase(0, chunk.find_first_not_of(" \n") + 1);
+            }
+        }
+    }
+
+    return chunks;
+}
+
 std::string DataNode::toStr(const c4::csubstr& buffer) const {
     std::string key;
     ryml::from_chars(buffer, &key);
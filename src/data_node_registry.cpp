@@ -0,0 +1,116 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/data_node_registry.cpp
+ * @brief Implementation of the class DataNodeRegistry.
+ */
+#include "icarus/utils/data_node_registry.h"
+
+#include <algorithm>
+
+namespace icarus {
+
+namespace {
+
+/**
+ * @brief Writes the fields of a statistics object into a data node map.
+ */
+void statsToNode(const DataNode::Stats& stats, DataNode node) {
+    node["num_nodes"] << stats.num_nodes;
+    node["node_capacity"] << stats.node_capacity;
+    node["node_bytes"] << stats.node_bytes;
+    node["arena_used"] << stats.arena_used;
+    node["arena_reserved"] << stats.arena_reserved;
+    node["max_depth"] << stats.max_depth;
+    node["max_map_width"] << stats.max_map_width;
+    node["max_seq_width"] << stats.max_seq_width;
+}
+
+} // namespace
+
+DataNodeRegistry& DataNodeRegistry::getInstance() {
+    static DataNodeRegistry instance;
+    return instance;
+}
+
+void DataNodeRegistry::setEnabled(bool is_enabled) {
+    is_enabled_.store(is_enabled, std::memory_order_relaxed);
+}
+
+bool DataNodeRegistry::isEnabled() const {
+    return is_enabled_.load(std::memory_order_relaxed);
+}
+
+void DataNodeRegistry::record(const std::string& source, const DataNode::Stats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SourceStats& entry = sources_[source];
+
+    ++entry.num_loads;
+    entry.last = stats;
+
+    DataNode::Stats& peak = entry.peak;
+    peak.num_nodes = std::max(peak.num_nodes, stats.num_nodes);
+    peak.node_capacity = std::max(peak.node_capacity, stats.node_capacity);
+    peak.node_bytes = std::max(peak.node_bytes, stats.node_bytes);
+    peak.arena_used = std::max(peak.arena_used, stats.arena_used);
+    peak.arena_reserved = std::max(peak.arena_reserved, stats.arena_reserved);
+    peak.max_depth = std::max(peak.max_depth, stats.max_depth);
+    peak.max_map_width = std::max(peak.max_map_width, stats.max_map_width);
+    peak.max_seq_width = std::max(peak.max_seq_width, stats.max_seq_width);
+}
+
+DataNodeRegistry::SourceStats DataNodeRegistry::getSourceStats(const std::string& source) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sources_.find(source);
+    if (it == sources_.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+std::map<std::string, DataNodeRegistry::SourceStats> DataNodeRegistry::getAllStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sources_;
+}
+
+DataNode::Stats DataNodeRegistry::getTotal() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DataNode::Stats total;
+    for (const auto& [source, entry] : sources_) {
+        total.num_nodes += entry.last.num_nodes;
+        total.node_capacity += entry.last.node_capacity;
+        total.node_bytes += entry.last.node_bytes;
+        total.arena_used += entry.last.arena_used;
+        total.arena_reserved += entry.last.arena_reserved;
+        total.max_depth = std::max(total.max_depth, entry.last.max_depth);
+        total.max_map_width = std::max(total.max_map_width, entry.last.max_map_width);
+        total.max_seq_width = std::max(total.max_seq_width, entry.last.max_seq_width);
+    }
+    return total;
+}
+
+DataNode DataNodeRegistry::toDataNode() const {
+    DataNode report(DataNode::Type::kMap);
+    for (const auto& [source, entry] : getAllStats()) {
+        DataNode source_node = report[source];
+        source_node.setType(DataNode::Type::kMap);
+        source_node["num_loads"] << entry.num_loads;
+
+        DataNode last_node = source_node["last"];
+        last_node.setType(DataNode::Type::kMap);
+        statsToNode(entry.last, last_node);
+
+        DataNode peak_node = source_node["peak"];
+        peak_node.setType(DataNode::Type::kMap);
+        statsToNode(entry.peak, peak_node);
+    }
+    return report;
+}
+
+void DataNodeRegistry::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.clear();
+}
+
+} // namespace icarus
@@ -0,0 +1,501 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/expression.cpp
+ * @brief Implementation of the class Expression.
+ */
+#include "icarus/utils/expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace icarus {
+
+// ================================
+// Parser class
+// ================================
+
+/**
+ * @brief Recursive descent parser emitting the bytecode of an expression.
+ */
+class Expression::Parser {
+public:
+    Parser(Expression& expr, const std::vector<std::string>& slot_names)
+            : expr_(expr), slot_names_(slot_names), src_(expr.source_) {}
+
+    /**
+     * @brief Parses the whole source string of the expression.
+     */
+    void parse() {
+        next();
+        parseOr();
+        if (token_.kind != Token::kEnd) {
+            error("Unexpected token '" + std::string(token_.text) + "'");
+        }
+    }
+
+private:
+    /// Maximum nesting of recursive rules (unary operators and parentheses).
+    static constexpr size_t kMaxNestingDepth = 256;
+
+    /**
+     * @brief Tracks the nesting of recursive rules, bounding the recursion on the C++ stack.
+     */
+    class NestingGuard {
+    public:
+        explicit NestingGuard(Parser& parser) : parser_(parser) {
+            if (++parser_.nesting_depth_ > kMaxNestingDepth) {
+                --parser_.nesting_depth_;
+                parser_.error("Expression is nested too deeply");
+            }
+        }
+
+        ~NestingGuard() {
+            --parser_.nesting_depth_;
+        }
+
+        NestingGuard(const NestingGuard&) = delete;
+        NestingGuard& operator=(const NestingGuard&) = delete;
+
+    private:
+        Parser& parser_;  ///< Parser whose nesting is tracked.
+    };
+
+    /**
+     * @brief Lexical token of the expression string.
+     */
+    struct Token {
+        enum Kind { kEnd, kNumber, kIdent, kSymbol } kind = kEnd;  ///< Kind of the token.
+        std::string_view text;                                      ///< Text of the token.
+        size_t pos = 0;                                             ///< Position in the source.
+    };
+
+    /**
+     * @brief Reads the next token from the source string.
+     */
+    void next() {
+        while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) {
+            ++pos_;
+        }
+
+        token_.pos = pos_;
+        if (pos_ >= src_.size()) {
+            token_ = {Token::kEnd, {}, pos_};
+            return;
+        }
+
+        size_t start = pos_;
+        unsigned char ch = static_cast<unsigned char>(src_[pos_]);
+        if (std::isdigit(ch) || (ch == '.' && pos_ + 1 < src_.size() &&
+                                 std::isdigit(static_cast<unsigned char>(src_[pos_ + 1])))) {
+            // Number: digits [. digits] [e [+-] digits]
+            while (pos_ < src_.size() && (std::isdigit(static_cast<unsigned char>(src_[pos_])) ||
+                                          src_[pos_] == '.')) {
+                ++pos_;
+            }
+            if (pos_ < src_.size() && (src_[pos_] == 'e' || src_[pos_] == 'E')) {
+                ++pos_;
+                if (pos_ < src_.size() && (src_[pos_] == '+' || src_[pos_] == '-')) {
+                    ++pos_;
+                }
+                while (pos_ < src_.size() && std::isdigit(static_cast<unsigned char>(src_[pos_]))) {
+                    ++pos_;
+                }
+            }
+            token_ = {Token::kNumber, src_.substr(start, pos_ - start), start};
+        } else if (std::isalpha(ch) || ch == '_') {
+            // Identifier, possibly qualified (e.g., "port.field")
+            while (pos_ < src_.size() && (std::isalnum(static_cast<unsigned char>(src_[pos_])) ||
+                                          src_[pos_] == '_' || src_[pos_] == '.')) {
+                ++pos_;
+            }
+            token_ = {Token::kIdent, src_.substr(start, pos_ - start), start};
+        } else {
+            static const char* const kTwoCharSymbols[] = {"==", "!=", "<=", ">=", "&&", "||"};
+            std::string_view two_chars = src_.substr(pos_, 2);
+            pos_ += std::find(std::begin(kTwoCharSymbols), std::end(kTwoCharSymbols), two_chars) !=
+                    std::end(kTwoCharSymbols) ? 2 : 1;
+            token_ = {Token::kSymbol, src_.substr(start, pos_ - start), start};
+        }
+    }
+
+    /**
+     * @brief Consumes the current token if it has a given text.
+     */
+    bool accept(std::string_view text) {
+        if (token_.kind != Token::kEnd && token_.kind != Token::kNumber && token_.text == text) {
+            next();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Consumes the current token, which must have a given text.
+     */
+    void expect(std::string_view text) {
+        if (!accept(text)) {
+            error("Expected '" + std::string(text) + "'");
+        }
+    }
+
+    void parseOr() {
+        parseAnd();
+        while (accept("or") || accept("||")) {
+            parseAnd();
+            addInstruction(OpCode::kOr);
+        }
+    }
+
+    void parseAnd() {
+        parseNot();
+        while (accept("and") || accept("&&")) {
+            parseNot();
+            addInstruction(OpCode::kAnd);
+        }
+    }
+
+    void parseNot() {
+        NestingGuard guard(*this);
+        if (accept("not") || accept("!")) {
+            parseNot();
+            addInstruction(OpCode::kNot);
+        } else {
+            parseComparison();
+        }
+    }
+
+    void parseComparison() {
+        parseAdditive();
+
+        static const std::pair<const char*, OpCode> kComparisons[] = {
+            {"==", OpCode::kEq}, {"!=", OpCode::kNe}, {"<=", OpCode::kLe},
+            {">=", OpCode::kGe}, {"<", OpCode::kLt}, {">", OpCode::kGt}
+        };
+        for (const auto& [text, op] : kComparisons) {
+            if (accept(text)) {
+                parseAdditive();
+                addInstruction(op);
+                break;
+            }
+        }
+    }
+
+    void parseAdditive() {
+        parseMultiplicative();
+        while (true) {
+            if (accept("+")) {
+                parseMultiplicative();
+                addInstruction(OpCode::kAdd);
+            } else if (accept("-")) {
+                parseMultiplicative();
+                addInstruction(OpCode::kSub);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parseMultiplicative() {
+        parseUnary();
+        while (true) {
+            if (accept("*")) {
+                parseUnary();
+                addInstruction(OpCode::kMul);
+            } else if (accept("/")) {
+                parseUnary();
+                addInstruction(OpCode::kDiv);
+            } else if (accept("%")) {
+                parseUnary();
+                addInstruction(OpCode::kMod);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parseUnary() {
+        NestingGuard guard(*this);
+        if (accept("-")) {
+            parseUnary();
+            addInstruction(OpCode::kNeg);
+        } else if (accept("+")) {
+            parseUnary();
+        } else {
+            parsePrimary();
+        }
+    }
+
+    void parsePrimary() {
+        if (token_.kind == Token::kNumber) {
+            std::string number(token_.text);
+            char* end = nullptr;
+            double value = std::strtod(number.c_str(), &end);
+            if (end != number.c_str() + number.size()) {
+                error("Invalid number '" + number + "'");
+            }
+            emitConst(value);
+            next();
+        } else if (token_.kind == Token::kIdent) {
+            std::string_view name = token_.text;
+            next();
+
+            if (name == "True" || name == "true") {
+                emitConst(1.0);
+            } else if (name == "False" || name == "false") {
+                emitConst(0.0);
+            } else if (accept("(")) {
+                parseCall(name);
+            } else {
+                auto it = std::find(slot_names_.begin(), slot_names_.end(), name);
+                if (it == slot_names_.end()) {
+                    error("Unknown identifier '" + std::string(name) + "'");
+                }
+                addInstruction(OpCode::kLoad, static_cast<uint32_t>(it - slot_names_.begin()));
+            }
+        } else if (accept("(")) {
+            parseOr();
+            expect(")");
+        } else if (token_.kind == Token::kEnd) {
+            error("Unexpected end of expression");
+        } else {
+            error("Unexpected token '" + std::string(token_.text) + "'");
+        }
+    }
+
+    /**
+     * @brief Parses the arguments of a function call (after the opening parenthesis).
+     */
+    void parseCall(std::string_view name) {
+        if (name == "abs") {
+            parseOr();
+            addInstruction(OpCode::kAbs);
+        } else if (name == "min" || name == "max") {
+            parseOr();
+            expect(",");
+            parseOr();
+            addInstruction(name == "min" ? OpCode::kMin : OpCode::kMax);
+        } else {
+            error("Unknown function '" + std::string(name) + "'");
+        }
+        expect(")");
+    }
+
+    void emitConst(double value) {
+        expr_.constants_.push_back(value);
+        addInstruction(OpCode::kConst, static_cast<uint32_t>(expr_.constants_.size() - 1));
+    }
+
+    /**
+     * @brief Appends an instruction to the bytecode and tracks the stack depth.
+     */
+    void addInstruction(OpCode op, uint32_t arg = 0) {
+        switch (op) {
+            case OpCode::kConst:
+            case OpCode::kLoad:
+                ++depth_;
+                break;
+            case OpCode::kNeg:
+            case OpCode::kNot:
+            case OpCode::kAbs:
+                break;
+            default:
+                --depth_;
+                break;
+        }
+        if (depth_ > kMaxStackDepth) {
+            error("Expression is nested too deeply");
+        }
+        expr_.max_stack_depth_ = std::max(expr_.max_stack_depth_, depth_);
+        expr_.code_.push_back({op, arg});
+    }
+
+    [[noreturn]] void error(const std::string& message) const {
+        throw std::runtime_error(message + " at position " + std::to_string(token_.pos) +
+                                 " in expression: " + std::string(src_));
+    }
+
+    /// Expression to emit the bytecode into.
+    Expression& expr_;
+    /// Names of the slots.
+    const std::vector<std::string>& slot_names_;
+    /// Source string of the expression.
+    std::string_view src_;
+    /// Position of the next character to read.
+    size_t pos_ = 0;
+    /// Current token.
+    Token token_;
+    /// Current depth of the evaluation stack.
+    size_t depth_ = 0;
+    /// Current nesting of recursive rules.
+    size_t nesting_depth_ = 0;
+};
+
+// End Parser class ===============
+
+Expression::Expression(const std::string& source, const std::vector<std::string>& slot_names)
+        : source_(source),
+          num_slots_(slot_names.size()) {
+    Parser(*this, slot_names).parse();
+}
+
+Expression::Expression(const DataNode& node, const std::vector<std::string>& slot_names)
+        : Expression(node.as_str(), slot_names) {}
+
+double Expression::evaluate(const double* values) const {
+    double stack[kMaxStackDepth];
+    size_t top = 0;
+
+    for (const Instruction& instr : code_) {
+        switch (instr.op) {
+            case OpCode::kConst: stack[top++] = constants_[instr.arg]; break;
+            case OpCode::kLoad:  stack[top++] = values[instr.arg]; break;
+            case OpCode::kNeg:   stack[top - 1] = -stack[top - 1]; break;
+            case OpCode::kNot:   stack[top - 1] = (stack[top - 1] == 0.0) ? 1.0 : 0.0; break;
+            case OpCode::kAbs:   stack[top - 1] = std::fabs(stack[top - 1]); break;
+            default: {
+                double rhs = stack[--top];
+                double& lhs = stack[top - 1];
+                switch (instr.op) {
+                    case OpCode::kAdd: lhs = lhs + rhs; break;
+                    case OpCode::kSub: lhs = lhs - rhs; break;
+                    case OpCode::kMul: lhs = lhs * rhs; break;
+                    case OpCode::kDiv: lhs = lhs / rhs; break;
+                    case OpCode::kMod: lhs = std::fmod(lhs, rhs); break;
+                    case OpCode::kMin: lhs = std::min(lhs, rhs); break;
+                    case OpCode::kMax: lhs = std::max(lhs, rhs); break;
+                    case OpCode::kEq:  lhs = (lhs == rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kNe:  lhs = (lhs != rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kLt:  lhs = (lhs < rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kLe:  lhs = (lhs <= rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kGt:  lhs = (lhs > rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kGe:  lhs = (lhs >= rhs) ? 1.0 : 0.0; break;
+                    case OpCode::kAnd: lhs = (lhs != 0.0 && rhs != 0.0) ? 1.0 : 0.0; break;
+                    case OpCode::kOr:  lhs = (lhs != 0.0 || rhs != 0.0) ? 1.0 : 0.0; break;
+                    default: break;
+                }
+                break;
+            }
+        }
+    }
+
+    return stack[0];
+}
+
+double Expression::evaluate(const std::vector<double>& values) const {
+    if (values.size() < num_slots_) {
+        throw std::runtime_error("Not enough values to evaluate expression: " + source_);
+    }
+    return evaluate(values.data());
+}
+
+bool Expression::isSatisfied(const std::vector<double>& values) const {
+    return evaluate(values) != 0.0;
+}
+
+void Expression::evaluateBatch(const double* const* columns, size_t num_samples,
+                               double* results) const {
+    // One row of the block stack per stack level
+    std::vector<double> block_stack(max_stack_depth_ * kBatchBlockSize);
+
+    for (size_t start = 0; start < num_samples; start += kBatchBlockSize) {
+        const size_t n = std::min(kBatchBlockSize, num_samples - start);
+        size_t top = 0;
+
+        auto row = [&block_stack](size_t level) {
+            return block_stack.data() + level * kBatchBlockSize;
+        };
+        auto unary = [&](auto fn) {
+            double* x = row(top - 1);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = fn(x[i]);
+            }
+        };
+        auto binary = [&](auto fn) {
+            double* lhs = row(top - 2);
+            const double* rhs = row(top - 1);
+            for (size_t i = 0; i < n; ++i) {
+                lhs[i] = fn(lhs[i], rhs[i]);
+            }
+            --top;
+        };
+
+        for (const Instruction& instr : code_) {
+            switch (instr.op) {
+                case OpCode::kConst:
+                    std::fill_n(row(top++), n, constants_[instr.arg]);
+                    break;
+                case OpCode::kLoad:
+                    std::copy_n(columns[instr.arg] + start, n, row(top++));
+                    break;
+                case OpCode::kNeg: unary([](double x) { return -x; }); break;
+                case OpCode::kNot: unary([](double x) { return (x == 0.0) ? 1.0 : 0.0; }); break;
+                case OpCode::kAbs: unary([](double x) { return std::fabs(x); }); break;
+                case OpCode::kAdd: binary([](double a, double b) { return a + b; }); break;
+                case OpCode::kSub: binary([](double a, double b) { return a - b; }); break;
+                case OpCode::kMul: binary([](double a, double b) { return a * b; }); break;
+                case OpCode::kDiv: binary([](double a, double b) { return a / b; }); break;
+                case OpCode::kMod: binary([](double a, double b) { return std::fmod(a, b); }); break;
+                case OpCode::kMin: binary([](double a, double b) { return std::min(a, b); }); break;
+                case OpCode::kMax: binary([](double a, double b) { return std::max(a, b); }); break;
+                case OpCode::kEq: binary([](double a, double b) { return (a == b) ? 1.0 : 0.0; }); break;
+                case OpCode::kNe: binary([](double a, double b) { return (a != b) ? 1.0 : 0.0; }); break;
+                case OpCode::kLt: binary([](double a, double b) { return (a < b) ? 1.0 : 0.0; }); break;
+                case OpCode::kLe: binary([](double a, double b) { return (a <= b) ? 1.0 : 0.0; }); break;
+                case OpCode::kGt: binary([](double a, double b) { return (a > b) ? 1.0 : 0.0; }); break;
+                case OpCode::kGe: binary([](double a, double b) { return (a >= b) ? 1.0 : 0.0; }); break;
+                case OpCode::kAnd:
+                    binary([](double a, double b) { return (a != 0.0 && b != 0.0) ? 1.0 : 0.0; });
+                    break;
+                case OpCode::kOr:
+                    binary([](double a, double b) { return (a != 0.0 || b != 0.0) ? 1.0 : 0.0; });
+                    break;
+            }
+        }
+
+        std::copy_n(row(0), n, results + start);
+    }
+}
+
+std::vector<double> Expression::evaluateBatch(
+        const std::vector<std::vector<double>>& columns) const {
+    if (columns.size() < num_slots_) {
+        throw std::runtime_error("Not enough columns to evaluate expression: " + source_);
+    }
+
+    size_t num_samples = columns.empty() ? 0 : columns[0].size();
+    std::vector<const double*> column_ptrs;
+    column_ptrs.reserve(columns.size());
+    for (const auto& column : columns) {
+        if (column.size() != num_samples) {
+            throw std::runtime_error("Columns of different lengths for expression: " + source_);
+        }
+        column_ptrs.push_back(column.data());
+    }
+
+    std::vector<double> results(num_samples);
+    evaluateBatch(column_ptrs.data(), num_samples, results.data());
+    return results;
+}
+
+const std::string& Expression::getSource() const {
+    return source_;
+}
+
+std::vector<size_t> Expression::getUsedSlots() const {
+    std::vector<size_t> slots;
+    for (const Instruction& instr : code_) {
+        if (instr.op == OpCode::kLoad) {
+            slots.push_back(instr.arg);
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+    return slots;
+}
+
+} // namespace icarus
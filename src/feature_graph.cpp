@@ -0,0 +1,336 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/feature_graph.cpp
+ * @brief Implementation of the class FeatureGraph.
+ */
+#include "icarus/utils/feature_graph.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace icarus {
+
+namespace {
+
+/// Number of feature types (size of FeatureGraph::FeatureType).
+constexpr size_t kNumFeatureTypes = 5;
+
+FeatureGraph::FeatureType parseFeatureType(std::string_view type, const std::string& name) {
+    if (type == "mandatory") {
+        return FeatureGraph::FeatureType::kMandatory;
+    } else if (type == "optional") {
+        return FeatureGraph::FeatureType::kOptional;
+    } else if (type == "XOR" || type == "xor") {
+        return FeatureGraph::FeatureType::kXor;
+    } else if (type == "OR" || type == "or") {
+        return FeatureGraph::FeatureType::kOr;
+    }
+    throw std::runtime_error("Unknown type '" + std::string(type) + "' of feature: " + name);
+}
+
+} // namespace
+
+// ================================
+// FeatureSet class
+// ================================
+
+FeatureGraph::FeatureSet::FeatureSet(size_t num_features)
+        : num_features_(num_features), words_((num_features + 63) / 64, 0) {}
+
+void FeatureGraph::FeatureSet::insert(FeatureId id) {
+    if (id >= num_features_) {
+        throw std::runtime_error("Feature ID out of range of the feature set: " + std::to_string(id));
+    }
+    words_[id >> 6] |= uint64_t{1} << (id & 63);
+}
+
+void FeatureGraph::FeatureSet::erase(FeatureId id) {
+    if (id >= num_features_) {
+        throw std::runtime_error("Feature ID out of range of the feature set: " + std::to_string(id));
+    }
+    words_[id >> 6] &= ~(uint64_t{1} << (id & 63));
+}
+
+size_t FeatureGraph::FeatureSet::count() const {
+    size_t num = 0;
+    for (uint64_t word : words_) {
+        for (; word != 0; word &= word - 1) {
+            ++num;
+        }
+    }
+    return num;
+}
+
+size_t FeatureGraph::FeatureSet::getNumFeatures() const {
+    return num_features_;
+}
+
+// End FeatureSet class ===========
+
+FeatureGraph::FeatureGraph(const DataNode& fm_spec) {
+    if (!fm_spec.isMap() || !fm_spec.hasChild("ROOT") || !fm_spec.hasChild("FEATURES")) {
+        throw std::runtime_error("Feature model must be a map with the keys ROOT and FEATURES.");
+    }
+
+    // Single pass over the FEATURES sequence: intern names in order of appearance.
+    // Parents may be referenced before their definition.
+    std::vector<std::string> names;
+    std::unordered_map<std::string, FeatureId> ids;
+    std::vector<FeatureType> types;
+    std::vector<FeatureId> parents;
+    std::vector<uint8_t> is_defined;
+
+    auto intern = [&](std::string_view name) {
+        auto [it, is_new] = ids.emplace(std::string(name), static_cast<FeatureId>(names.size()));
+        if (is_new) {
+            names.emplace_back(name);
+            types.push_back(FeatureType::kOptional);
+            parents.push_back(kInvalidId);
+            is_defined.push_back(0);
+        }
+        return it->second;
+    };
+
+    FeatureId root = intern(fm_spec["ROOT"].getValView());
+    types[root] = FeatureType::kRoot;
+    is_defined[root] = 1;
+
+    DataNode features = fm_spec["FEATURES"];
+    if (!features.isSeq()) {
+        throw std::runtime_error("FEATURES of the feature model must be a sequence.");
+    }
+    for (const auto& item : features) {
+        if (!item.isMap() || item.getNumChildren() != 1) {
+            throw std::runtime_error("Each element of FEATURES must be a single-key map.");
+        }
+        DataNode feature = item.first();
+        FeatureId id = intern(feature.getKeyView());
+        const std::string& name = names[id];
+
+        if (is_defined[id]) {
+            throw std::runtime_error("Feature defined more than once: " + name);
+        }
+        if (!feature.hasChild("type") || !feature.hasChild("parent")) {
+            throw std::runtime_error("Feature without type or parent: " + name);
+        }
+        is_defined[id] = 1;
+        types[id] = parseFeatureType(feature["type"].getValView(), name);
+
+        // Interning may grow the arrays, so it must not be mixed with indexing them
+        FeatureId parent = intern(feature["parent"].getValView());
+        parents[id] = parent;
+    }
+
+    const size_t num_features = names.size();
+    for (FeatureId id = 0; id < num_features; ++id) {
+        if (!is_defined[id]) {
+            throw std::runtime_error("Parent feature is not defined: " + names[id]);
+        }
+    }
+
+    // CSR children arrays in interning order (counting sort by parent)
+    std::vector<uint32_t> offsets(num_features + 1, 0);
+    for (FeatureId id = 0; id < num_features; ++id) {
+        if (parents[id] != kInvalidId) {
+            ++offsets[parents[id] + 1];
+        }
+    }
+    for (size_t i = 0; i < num_features; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<FeatureId> children(offsets[num_features]);
+    std::vector<uint32_t> fill_pos(offsets.begin(), offsets.end() - 1);
+    for (FeatureId id = 0; id < num_features; ++id) {
+        if (parents[id] != kInvalidId) {
+            children[fill_pos[parents[id]]++] = id;
+        }
+    }
+
+    // Depth-first preorder numbering starting at the root
+    std::vector<FeatureId> new_ids(num_features, kInvalidId);
+    std::vector<FeatureId> order;
+    order.reserve(num_features);
+    std::vector<FeatureId> stack = {root};
+    while (!stack.empty()) {
+        FeatureId id = stack.back();
+        stack.pop_back();
+        new_ids[id] = static_cast<FeatureId>(order.size());
+        order.push_back(id);
+
+        // Push in reverse to visit the children in definition order
+        for (uint32_t i = offsets[id + 1]; i > offsets[id]; --i) {
+            stack.push_back(children[i - 1]);
+        }
+    }
+    if (order.size() != num_features) {
+        for (FeatureId id = 0; id < num_features; ++id) {
+            if (new_ids[id] == kInvalidId) {
+                throw std::runtime_error("Feature is not reachable from the root: " + names[id]);
+            }
+        }
+    }
+
+    // Build the final arrays in preorder
+    names_.resize(num_features);
+    types_.resize(num_features);
+    parents_.resize(num_features);
+    depths_.resize(num_features);
+    subtree_ends_.resize(num_features);
+    type_sets_.assign(kNumFeatureTypes, FeatureSet(num_features));
+    child_offsets_.assign(num_features + 1, 0);
+    children_.clear();
+    children_.reserve(children.size());
+    ids_.reserve(num_features);
+
+    for (FeatureId new_id = 0; new_id < num_features; ++new_id) {
+        FeatureId old_id = order[new_id];
+        names_[new_id] = std::move(names[old_id]);
+        ids_.emplace(names_[new_id], new_id);
+        types_[new_id] = types[old_id];
+        type_sets_[static_cast<size_t>(types[old_id])].insert(new_id);
+
+        FeatureId parent = parents[old_id];
+        parents_[new_id] = (parent == kInvalidId) ? kInvalidId : new_ids[parent];
+        depths_[new_id] = (parent == kInvalidId) ? 0 : depths_[parents_[new_id]] + 1;
+
+        for (uint32_t i = offsets[old_id]; i < offsets[old_id + 1]; ++i) {
+            children_.push_back(new_ids[children[i]]);
+        }
+        child_offsets_[new_id + 1] = static_cast<uint32_t>(children_.size());
+    }
+
+    // Subtree ends in reverse preorder: a feature's subtree ends where its last child's ends
+    for (FeatureId id = static_cast<FeatureId>(num_features); id-- > 0;) {
+        ChildRange feature_children = getChildren(id);
+        subtree_ends_[id] = feature_children.empty() ? id + 1
+                                                     : subtree_ends_[*(feature_children.end() - 1)];
+    }
+}
+
+size_t FeatureGraph::getNumFeatures() const {
+    return names_.size();
+}
+
+FeatureGraph::FeatureId FeatureGraph::getRootId() const {
+    return 0;
+}
+
+FeatureGraph::FeatureId FeatureGraph::findFeature(const std::string& name) const {
+    auto it = ids_.find(name);
+    return (it == ids_.end()) ? kInvalidId : it->second;
+}
+
+const std::string& FeatureGraph::getName(FeatureId id) const {
+    return names_[id];
+}
+
+FeatureGraph::FeatureType FeatureGraph::getType(FeatureId id) const {
+    return types_[id];
+}
+
+bool FeatureGraph::isOfType(FeatureId id, FeatureType type) const {
+    return type_sets_[static_cast<size_t>(type)].contains(id);
+}
+
+FeatureGraph::FeatureId FeatureGraph::getParent(FeatureId id) const {
+    return parents_[id];
+}
+
+FeatureGraph::ChildRange FeatureGraph::getChildren(FeatureId id) const {
+    const FeatureId* data = children_.data();
+    return {data + child_offsets_[id], data + child_offsets_[id + 1]};
+}
+
+std::vector<FeatureGraph::FeatureId> FeatureGraph::getGroup(FeatureId id, FeatureType type) const {
+    std::vector<FeatureId> group;
+    for (FeatureId child : getChildren(id)) {
+        if (isOfType(child, type)) {
+            group.push_back(child);
+        }
+    }
+    return group;
+}
+
+size_t FeatureGraph::getDepth(FeatureId id) const {
+    return depths_[id];
+}
+
+bool FeatureGraph::isAncestor(FeatureId ancestor, FeatureId descendant) const {
+    return ancestor < descendant && descendant < subtree_ends_[ancestor];
+}
+
+FeatureGraph::FeatureSet FeatureGraph::makeFeatureSet(const std::vector<std::string>& names) const {
+    FeatureSet feature_set(getNumFeatures());
+    for (const auto& name : names) {
+        FeatureId id = findFeature(name);
+        if (id == kInvalidId) {
+            throw std::runtime_error("Unknown feature: " + name);
+        }
+        feature_set.insert(id);
+    }
+    return feature_set;
+}
+
+std::vector<std::string> FeatureGraph::validateConfiguration(const FeatureSet& config) const {
+    if (config.getNumFeatures() != getNumFeatures()) {
+        throw std::runtime_error("The configuration has " + std::to_string(config.getNumFeatures()) +
+                                 " features instead of " + std::to_string(getNumFeatures()) + ".");
+    }
+
+    std::vector<std::string> violations;
+    if (!config.contains(getRootId())) {
+        violations.push_back("Root feature is not selected: " + names_[getRootId()]);
+    }
+
+    for (FeatureId id = 0; id < getNumFeatures(); ++id) {
+        bool is_selected = config.contains(id);
+        if (is_selected && parents_[id] != kInvalidId && !config.contains(parents_[id])) {
+            violations.push_back("Feature selected without its parent: " + names_[id]);
+        }
+        if (!is_selected) {
+            continue;
+        }
+
+        // Check the groups of the children of the selected feature
+        size_t num_xor = 0;
+        size_t num_xor_selected = 0;
+        size_t num_or = 0;
+        size_t num_or_selected = 0;
+        for (FeatureId child : getChildren(id)) {
+            bool is_child_selected = config.contains(child);
+            switch (types_[child]) {
+                case FeatureType::kMandatory:
+                    if (!is_child_selected) {
+                        violations.push_back("Mandatory feature is not selected: " + names_[child]);
+                    }
+                    break;
+                case FeatureType::kXor:
+                    ++num_xor;
+                    num_xor_selected += is_child_selected ? 1 : 0;
+                    break;
+                case FeatureType::kOr:
+                    ++num_or;
+                    num_or_selected += is_child_selected ? 1 : 0;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (num_xor > 0 && num_xor_selected != 1) {
+            violations.push_back("Not exactly one feature of the XOR group of: " + names_[id]);
+        }
+        if (num_or > 0 && num_or_selected == 0) {
+            violations.push_back("No feature of the OR group of: " + names_[id]);
+        }
+    }
+
+    return violations;
+}
+
+bool FeatureGraph::isValidConfiguration(const FeatureSet& config) const {
+    return validateConfiguration(config).empty();
+}
+
+} // namespace icarus
@@ -0,0 +1,291 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/file_index.cpp
+ * @brief Implementation of the class FileIndex.
+ */
+#include "icarus/utils/file_index.h"
+
+#ifdef __linux__
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include "icarus/utils/thread_pool.h"
+
+namespace fs = std::filesystem;
+
+namespace icarus::utils {
+
+namespace {
+
+#ifdef __linux__
+
+/**
+ * @brief Shared state of a parallel scan.
+ */
+struct ScanState {
+    std::mutex mutex;                         ///< Mutex protecting the state.
+    std::condition_variable cv;               ///< Signals the end of the scan.
+    size_t num_pending = 0;                   ///< Number of directories left to scan.
+    std::vector<FileIndex::Entry> entries;    ///< Entries found so far.
+    std::exception_ptr error;                 ///< First error of a scan task, if any.
+};
+
+/**
+ * @brief Returns the offset of the epoch of the file clock to the Unix epoch.
+ *
+ * The epochs of the standard libraries differ by whole seconds (e.g., 2174-01-01 for
+ * libstdc++ and the Unix epoch for libc++). The offset is measured once between both
+ * clocks and rounded to seconds, which removes the time between the two readings.
+ *
+ * @returns Offset to add to a time since the Unix epoch to get a file time.
+ */
+std::chrono::nanoseconds getFileClockOffset() {
+    static const std::chrono::nanoseconds clock_offset = []() {
+        auto file_now = fs::file_time_type::clock::now().time_since_epoch();
+        auto system_now = std::chrono::system_clock::now().time_since_epoch();
+        return std::chrono::round<std::chrono::seconds>(file_now - system_now);
+    }();
+    return clock_offset;
+}
+
+/**
+ * @brief Converts a stat timestamp into a file time.
+ *
+ * @param time Timestamp of stat.
+ * @returns File time.
+ */
+fs::file_time_type toFileTime(const struct timespec& time) {
+    std::chrono::nanoseconds since_epoch = std::chrono::seconds(time.tv_sec) +
+                                           std::chrono::nanoseconds(time.tv_nsec);
+    return fs::file_time_type(std::chrono::duration_cast<fs::file_time_type::duration>(
+        since_epoch + getFileClockOffset()));
+}
+
+void scanDirectory(ScanState& state, const std::string& dir_path);
+
+/**
+ * @brief Scans the entries of one directory and queues its subdirectories.
+ *
+ * @param state Shared state of the scan.
+ * @param dir_path Absolute path of the directory.
+ */
+void scanEntries(ScanState& state, const std::string& dir_path) {
+    std::vector<FileIndex::Entry> entries;
+    std::vector<std::string> subdirs;
+
+    DIR* dir = opendir(dir_path.c_str());
+    if (dir != nullptr) {
+        int dir_fd = dirfd(dir);
+        std::string prefix = (dir_path.back() == '/') ? dir_path : dir_path + '/';
+        while (struct dirent* dir_entry = readdir(dir)) {
+            const char* name = dir_entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            // Links are indexed with their target but not followed into directories
+            bool is_link = (dir_entry->d_type == DT_LNK);
+            struct stat entry_stat;
+            if (dir_entry->d_type == DT_UNKNOWN) {
+                if (fstatat(dir_fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0) {
+                    continue;
+                }
+                is_link = S_ISLNK(entry_stat.st_mode);
+            }
+            if (fstatat(dir_fd, name, &entry_stat, 0) != 0 &&
+                fstatat(dir_fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+
+            FileIndex::Entry entry;
+            entry.path = prefix + name;
+            entry.mtime = toFileTime(entry_stat.st_mtim);
+            if (S_ISREG(entry_stat.st_mode)) {
+                entry.type = FileIndex::EntryType::kFile;
+                entry.size = static_cast<uintmax_t>(entry_stat.st_size);
+            }
+            else if (S_ISDIR(entry_stat.st_mode)) {
+                entry.type = FileIndex::EntryType::kDirectory;
+                if (!is_link) {
+                    subdirs.push_back(entry.path.native());
+                }
+            }
+            entries.push_back(std::move(entry));
+        }
+        closedir(dir);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.entries.insert(state.entries.end(), std::make_move_iterator(entries.begin()),
+                             std::make_move_iterator(entries.end()));
+        state.num_pending += subdirs.size();
+    }
+    for (size_t i = 0; i < subdirs.size(); ++i) {
+        try {
+            ThreadPool::getIo().submit([&state, subdir = std::move(subdirs[i])]() {
+                scanDirectory(state, subdir);
+            });
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.num_pending -= subdirs.size() - i;  // Subdirectories never scanned
+            throw;
+        }
+    }
+}
+
+/**
+ * @brief Scans a directory as a task of the scan and counts it as done, even on errors.
+ *
+ * @param state Shared state of the scan.
+ * @param dir_path Absolute path of the directory.
+ */
+void scanDirectory(ScanState& state, const std::string& dir_path) {
+    std::exception_ptr error;
+    try {
+        scanEntries(state, dir_path);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Always count the directory as done, as the scanning thread waits for all of them.
+    // Notify under the lock, as it may return right after the last one.
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error && !state.error) {
+        state.error = error;
+    }
+    if (--state.num_pending == 0) {
+        state.cv.notify_all();
+    }
+}
+
+#endif
+
+/**
+ * @brief Returns the extension of a path without dot.
+ *
+ * @param path Path of a file.
+ * @returns Extension, empty if the file has none.
+ */
+std::string getExtension(const fs::path& path) {
+    std::string extension = path.extension().string();
+    return extension.empty() ? extension : extension.substr(1);
+}
+
+} // namespace
+
+FileIndex::FileIndex(const fs::path& root_dir)
+        : root_dir_(fs::absolute(root_dir).lexically_normal()) {
+    if (root_dir_.has_relative_path() && !root_dir_.has_filename()) {
+        root_dir_ = root_dir_.parent_path();  // Trailing separator
+    }
+    rescan();
+}
+
+void FileIndex::rescan() {
+    std::error_code error;
+    if (!fs::is_directory(root_dir_, error)) {
+        throw std::runtime_error("The path is not a directory: " + root_dir_.string());
+    }
+
+    #ifdef __linux__
+        ScanState state;
+        state.num_pending = 1;
+        ThreadPool::getIo().submit([&state, this]() { scanDirectory(state, root_dir_.native()); });
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.cv.wait(lock, [&state]() { return state.num_pending == 0; });
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+        entries_ = std::move(state.entries);
+    #else
+        entries_.clear();
+        auto options = fs::directory_options::skip_permission_denied;
+        for (auto it = fs::recursive_directory_iterator(root_dir_, options, error);
+             !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+            // The iterator caches the attributes of the directory listing where available
+            Entry entry;
+            entry.path = it->path();
+            entry.mtime = it->last_write_time(error);
+            if (it->is_regular_file(error)) {
+                entry.type = EntryType::kFile;
+                entry.size = it->file_size(error);
+            }
+            else if (it->is_directory(error)) {
+                entry.type = EntryType::kDirectory;
+            }
+            error.clear();
+            entries_.push_back(std::move(entry));
+        }
+    #endif
+
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& a, const Entry& b) { return a.path < b.path; });
+    entry_ids_.clear();
+    extension_ids_.clear();
+    entry_ids_.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        entry_ids_.emplace(entries_[i].path.string(), i);
+        if (entries_[i].type == EntryType::kFile) {
+            extension_ids_[getExtension(entries_[i].path)].push_back(i);
+        }
+    }
+}
+
+const fs::path& FileIndex::getRootDir() const {
+    return root_dir_;
+}
+
+const std::vector<FileIndex::Entry>& FileIndex::getEntries() const {
+    return entries_;
+}
+
+const FileIndex::Entry* FileIndex::find(const fs::path& path) const {
+    auto it = entry_ids_.find(getKey(path));
+    return (it == entry_ids_.end()) ? nullptr : &entries_[it->second];
+}
+
+bool FileIndex::isValidFile(const fs::path& file_path, const std::string& extension) const {
+    const Entry* entry = find(file_path);
+    return entry != nullptr && entry->type == EntryType::kFile &&
+           getExtension(entry->path) == extension;
+}
+
+std::vector<const FileIndex::Entry*> FileIndex::getFilesWithExtension(
+        const std::string& extension) const {
+    std::vector<const Entry*> files;
+    auto it = extension_ids_.find(extension);
+    if (it != extension_ids_.end()) {
+        files.reserve(it->second.size());
+        for (size_t id : it->second) {
+            files.push_back(&entries_[id]);
+        }
+    }
+    return files;
+}
+
+const FileIndex::Entry* FileIndex::resolve(const fs::path& dir_path,
+                                           const std::string& target_path) const {
+    fs::path target(target_path);
+    return find(target.is_relative() ? dir_path / target : target);
+}
+
+std::string FileIndex::getKey(const fs::path& path) const {
+    fs::path key = (path.is_relative() ? root_dir_ / path : path).lexically_normal();
+    if (key.has_relative_path() && !key.has_filename()) {
+        key = key.parent_path();  // Trailing separator
+    }
+    return key.string();
+}
+
+} // namespace icarus::utils
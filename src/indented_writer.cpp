@@ -0,0 +1,139 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/indented_writer.cpp
+ * @brief Implementation of the class IndentedWriter.
+ */
+#include "icarus/utils/indented_writer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace icarus::utils {
+
+IndentedWriter::IndentedWriter(Sink sink, size_t buffer_size)
+        : sink_(std::move(sink)), buffer_size_(buffer_size) {
+    buffer_.reserve(buffer_size_);
+}
+
+IndentedWriter::~IndentedWriter() {
+    flush();
+}
+
+IndentedWriter IndentedWriter::toFile(std::FILE* file) {
+    return IndentedWriter([file](std::string_view text) {
+        std::fwrite(text.data(), 1, text.size(), file);
+    });
+}
+
+IndentedWriter IndentedWriter::toString(std::string& str) {
+    return IndentedWriter([&str](std::string_view text) {
+        str.append(text);
+    });
+}
+
+IndentedWriter IndentedWriter::toLogger(std::shared_ptr<spdlog::logger> logger,
+                                        spdlog::level::level_enum level) {
+    return IndentedWriter([logger, level](std::string_view text) {
+        while (!text.empty()) {
+            size_t line_end = text.find('\n');
+            std::string_view line = text.substr(0, line_end);
+            logger->log(level, "{}", line);
+            text.remove_prefix((line_end == std::string_view::npos) ? text.size() : line_end + 1);
+        }
+    });
+}
+
+void IndentedWriter::pushIndent(std::string_view indent, bool is_hanging) {
+    levels_.push_back({prefix_.size(), is_hanging});
+    prefix_.append(indent);
+    has_hanging_ = has_hanging_ || is_hanging;
+}
+
+void IndentedWriter::pushIndent(size_t num_spaces) {
+    levels_.push_back({prefix_.size(), false});
+    prefix_.append(num_spaces, ' ');
+}
+
+void IndentedWriter::popIndent() {
+    if (levels_.empty()) {
+        throw std::runtime_error("No indentation level to pop.");
+    }
+    prefix_.resize(levels_.back().offset);
+    levels_.pop_back();
+}
+
+size_t IndentedWriter::getIndentLevel() const {
+    return levels_.size();
+}
+
+void IndentedWriter::write(std::string_view text) {
+    while (!text.empty()) {
+        if (is_line_start_) {
+            append(prefix_);
+            is_line_start_ = false;
+        }
+
+        const void* newline = std::memchr(text.data(), '\n', text.size());
+        size_t length = (newline == nullptr)
+                            ? text.size()
+                            : static_cast<size_t>(static_cast<const char*>(newline) - text.data()) + 1;
+        append(text.substr(0, length));
+        text.remove_prefix(length);
+
+        if (newline != nullptr) {
+            is_line_start_ = true;
+            endLine();
+        }
+    }
+}
+
+void IndentedWriter::writeLine(std::string_view text) {
+    write(text);
+    write("\n");
+}
+
+void IndentedWriter::writeRaw(std::string_view text) {
+    append(text);
+}
+
+void IndentedWriter::flush() {
+    if (!buffer_.empty() && sink_) {
+        sink_(buffer_);
+        buffer_.clear();
+    }
+}
+
+void IndentedWriter::append(std::string_view text) {
+    if (buffer_.size() + text.size() > buffer_size_) {
+        // Pass only complete lines, so that no line is split between two sink calls
+        size_t line_end = buffer_.rfind('\n');
+        if (line_end != std::string::npos && sink_) {
+            sink_(std::string_view(buffer_).substr(0, line_end + 1));
+            buffer_.erase(0, line_end + 1);
+        }
+        if (buffer_.empty() && text.size() > buffer_size_ && text.back() == '\n' && sink_) {
+            sink_(text);  // Complete lines too large for the buffer: bypass it
+            return;
+        }
+    }
+    buffer_.append(text);
+}
+
+void IndentedWriter::endLine() {
+    if (!has_hanging_) {
+        return;
+    }
+    for (size_t i = 0; i < levels_.size(); ++i) {
+        Level& level = levels_[i];
+        if (level.is_hanging) {
+            size_t end = (i + 1 < levels_.size()) ? levels_[i + 1].offset : prefix_.size();
+            prefix_.replace(level.offset, end - level.offset, end - level.offset, ' ');
+            level.is_hanging = false;
+        }
+    }
+    has_hanging_ = false;
+}
+
+} // namespace icarus::utils
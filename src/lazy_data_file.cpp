@@ -0,0 +1,418 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/lazy_data_file.cpp
+ * @brief Implementation of the class LazyDataFile.
+ */
+#include "icarus/utils/lazy_data_file.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace icarus {
+
+namespace {
+
+/**
+ * @brief State of the prescan inside a flow collection, which may span several lines.
+ */
+struct FlowState {
+    int depth = 0;   ///< Nesting depth of brackets.
+    char quote = 0;  ///< Quote character of an open quoted scalar, 0 if none.
+};
+
+/**
+ * @brief Checks whether a line is a document marker (`---` or `...`).
+ */
+bool isDocMarker(std::string_view line, std::string_view marker) {
+    return line.substr(0, 3) == marker &&
+           (line.size() == 3 || line[3] == ' ' || line[3] == '\t');
+}
+
+/**
+ * @brief Checks whether a character precedes a token in flow context.
+ */
+bool isTokenStart(char prev) {
+    return prev == ' ' || prev == '\t' || prev == '[' || prev == '{' || prev == ',';
+}
+
+/**
+ * @brief Scans (part of) a line inside a flow collection and updates the flow state.
+ *
+ * Scanning stops at a comment or when the outermost collection is closed.
+ */
+void scanFlow(std::string_view text, FlowState& state, bool& has_alias) {
+    char prev = ' ';
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (state.quote != 0) {
+            if (state.quote == '"' && c == '\\') {
+                ++i;  // Skip the escaped character
+            } else if (c == state.quote) {
+                if (c == '\'' && i + 1 < text.size() && text[i + 1] == '\'') {
+                    ++i;  // Escaped single quote
+                } else {
+                    state.quote = 0;
+                }
+            }
+            prev = c;
+            continue;
+        }
+
+        if ((c == '"' || c == '\'') && (isTokenStart(prev) || prev == ':')) {
+            state.quote = c;
+        } else if (c == '#' && (prev == ' ' || prev == '\t')) {
+            return;
+        } else if (c == '[' || c == '{') {
+            ++state.depth;
+        } else if (c == ']' || c == '}') {
+            if (--state.depth == 0) {
+                return;
+            }
+        } else if (c == '*' && isTokenStart(prev)) {
+            has_alias = true;
+        }
+        prev = c;
+    }
+}
+
+/**
+ * @brief Skips anchors and tags preceding a value.
+ */
+size_t skipProperties(std::string_view line, size_t pos) {
+    while (pos < line.size() && (line[pos] == '&' || line[pos] == '!')) {
+        pos = line.find(' ', pos);
+        if (pos == std::string_view::npos) {
+            return line.size();
+        }
+        pos = line.find_first_not_of(' ', pos);
+        if (pos == std::string_view::npos) {
+            return line.size();
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Finds the start of a value of a block line that opens a flow collection.
+ *
+ * @param line Line in block context.
+ * @param has_alias Set to true if the value of the line is an alias.
+ * @returns Position of the opening bracket, or npos if the value is no flow collection.
+ */
+size_t findFlowStart(std::string_view line, bool& has_alias) {
+    size_t pos = line.find_first_not_of(" \t");
+    if (pos == std::string_view::npos || line[pos] == '#') {
+        return std::string_view::npos;
+    }
+
+    // Sequence entries, possibly nested on the same line
+    while (line[pos] == '-' && (pos + 1 == line.size() || line[pos + 1] == ' ')) {
+        pos = line.find_first_not_of(' ', pos + 1);
+        if (pos == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+    }
+
+    auto checkValue = [&](size_t value_pos) {
+        value_pos = skipProperties(line, value_pos);
+        if (value_pos >= line.size()) {
+            return std::string_view::npos;
+        }
+        if (line[value_pos] == '*') {
+            has_alias = true;
+        }
+        return (line[value_pos] == '[' || line[value_pos] == '{') ? value_pos
+                                                                  : std::string_view::npos;
+    };
+    if (line[pos] == '[' || line[pos] == '{' || line[pos] == '*' || line[pos] == '&' ||
+            line[pos] == '!') {
+        return checkValue(pos);
+    }
+
+    // Key of a map entry, possibly quoted
+    size_t key_end = pos;
+    if (line[pos] == '"' || line[pos] == '\'') {
+        key_end = line.find(line[pos], pos + 1);
+        if (key_end == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+    }
+    size_t colon = line.find(": ", key_end);
+    if (colon == std::string_view::npos) {
+        return std::string_view::npos;
+    }
+    size_t comment = line.find(" #", key_end);
+    if (comment != std::string_view::npos && comment < colon) {
+        return std::string_view::npos;
+    }
+    size_t value_pos = line.find_first_not_of(' ', colon + 1);
+    return (value_pos == std::string_view::npos) ? value_pos : checkValue(value_pos);
+}
+
+/**
+ * @brief Extracts the key of a top-level map entry from a line at column 0.
+ *
+ * @param line Line starting with a key.
+ * @param key Set to the key (without quotes).
+ * @returns True if the line is a map entry, false otherwise.
+ */
+bool parseTopLevelKey(std::string_view line, std::string& key) {
+    size_t key_end = 0;
+    if (line[0] == '"' || line[0] == '\'') {
+        key_end = line.find(line[0], 1);
+        if (key_end == std::string_view::npos) {
+            return false;
+        }
+        key.assign(line.substr(1, key_end - 1));
+        ++key_end;
+        if (key_end >= line.size() || line[key_end] != ':') {
+            return false;
+        }
+        return key_end + 1 == line.size() || line[key_end + 1] == ' ' || line[key_end + 1] == '\t';
+    }
+
+    if (std::strchr("-?[{*&!|>%@`,#", line[0]) != nullptr) {
+        return false;
+    }
+    size_t colon = line.find(": ");
+    if (colon == std::string_view::npos) {
+        colon = line.find(":\t");
+    }
+    if (colon == std::string_view::npos) {
+        if (line.back() != ':') {
+            return false;
+        }
+        colon = line.size() - 1;
+    }
+    std::string_view plain_key = line.substr(0, colon);
+    size_t last = plain_key.find_last_not_of(" \t");
+    key.assign(plain_key.substr(0, last + 1));
+    return true;
+}
+
+} // namespace
+
+LazyDataFile::LazyDataFile(const std::string& file_path)
+        : file_path_(file_path),
+          content_(file_path, utils::MappedFile::AccessHint::kSequential) {
+    buildIndex();
+}
+
+LazyDataFile::~LazyDataFile() = default;
+
+const std::string& LazyDataFile::getFilePath() const {
+    return file_path_;
+}
+
+size_t LazyDataFile::getNumDocuments() const {
+    return documents_.size();
+}
+
+std::vector<std::string> LazyDataFile::getKeys(size_t doc_index) const {
+    const Document& document = getDocumentIndex(doc_index);
+    std::vector<std::string> keys;
+    keys.reserve(document.sections.size());
+    for (const auto& section : document.sections) {
+        keys.push_back(section.key);
+    }
+    return keys;
+}
+
+bool LazyDataFile::hasKey(const std::string& key, size_t doc_index) {
+    const Document& document = getDocumentIndex(doc_index);
+    if (document.is_sectioned) {
+        return document.section_ids.count(key) > 0;
+    }
+    DataNode root = getDocument(doc_index);
+    return root.isMap() && root.hasChild(key.c_str());
+}
+
+DataNode LazyDataFile::get(const std::string& key, size_t doc_index) {
+    getDocumentIndex(doc_index);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Document& document = documents_[doc_index];
+
+    if (!document.is_sectioned || document.node) {
+        DataNode root = getParsedDocument(document);
+        if (!root.isMap() || !root.hasChild(key.c_str())) {
+            throw std::runtime_error("Key '" + key + "' not found in: " + file_path_);
+        }
+        return root[key];
+    }
+
+    auto it = document.section_ids.find(key);
+    if (it == document.section_ids.end()) {
+        throw std::runtime_error("Key '" + key + "' not found in: " + file_path_);
+    }
+    Section& section = document.sections[it->second];
+    if (!section.node) {
+        // The section is a single-key map, whose only child is the value
+        section.node = parseRange(section.begin, section.end).first();
+        ++num_parsed_;
+    }
+    return *section.node;
+}
+
+DataNode LazyDataFile::getDocument(size_t doc_index) {
+    getDocumentIndex(doc_index);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return getParsedDocument(documents_[doc_index]);
+}
+
+size_t LazyDataFile::getNumParsed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_parsed_;
+}
+
+void LazyDataFile::buildIndex() {
+    const char* data = content_.data();
+    const size_t size = content_.size();
+
+    documents_.emplace_back();
+    Document* document = &documents_.back();
+    bool has_content = false;  // Content lines in the current document
+    bool is_closed = false;    // Current document ended with "..."
+    bool has_alias = false;
+    bool has_directives = false;  // Directives of the current document
+    FlowState flow;
+
+    auto closeSection = [&](size_t pos) {
+        if (!document->sections.empty() && document->sections.back().end == 0) {
+            document->sections.back().end = pos;
+        }
+    };
+    auto closeDocument = [&](size_t pos) {
+        closeSection(pos);
+        document->end = pos;
+        if (has_alias) {
+            document->is_sectioned = false;
+        }
+    };
+    auto startDocument = [&](size_t pos) {
+        documents_.emplace_back();
+        document = &documents_.back();
+        document->begin = pos;
+        has_content = false;
+        is_closed = false;
+        has_alias = false;
+        has_directives = false;
+    };
+
+    size_t pos = 0;
+    while (pos < size) {
+        const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        size_t line_end = (newline == nullptr) ? size : static_cast<size_t>(newline - data);
+        size_t next = (newline == nullptr) ? size : line_end + 1;
+        std::string_view line(data + pos, line_end - pos);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (flow.depth > 0) {
+            scanFlow(line, flow, has_alias);
+            pos = next;
+            continue;
+        }
+
+        if (isDocMarker(line, "---")) {
+            if (has_content || is_closed) {
+                closeDocument(pos);
+                startDocument(pos + 3);
+            } else if (!has_directives) {
+                document->begin = pos + 3;  // Explicit start of the current document
+            }
+            if (line.find_first_not_of(" \t", 3) != std::string_view::npos) {
+                // Content (e.g., a tag or flow collection) on the marker line
+                has_content = true;
+                document->is_sectioned = false;
+            }
+        } else if (isDocMarker(line, "...")) {
+            closeDocument(pos);
+            is_closed = true;
+        } else if (line[0] == '%' && (!has_content || is_closed)) {
+            if (is_closed) {
+                startDocument(pos);  // Directives of the next document
+            }
+            // Sections parsed alone would lose the directives, e.g., %TAG handles
+            has_directives = true;
+            document->is_sectioned = false;
+        } else if (line.empty() || line[0] == '#') {
+            // Blank line or comment
+        } else if (line[0] == ' ' || line[0] == '\t') {
+            if (line.find_first_not_of(" \t") != std::string_view::npos) {
+                has_content = true;
+            }
+        } else {
+            if (is_closed) {
+                startDocument(pos);  // Bare document after an end marker
+            }
+            has_content = true;
+
+            std::string key;
+            if (document->is_sectioned && parseTopLevelKey(line, key)) {
+                closeSection(pos);
+                if (document->section_ids.emplace(key, document->sections.size()).second) {
+                    document->sections.push_back({key, pos, 0, std::nullopt});
+                } else {
+                    document->is_sectioned = false;  // Duplicate keys are left to the parser
+                }
+            } else {
+                document->is_sectioned = false;
+            }
+        }
+
+        // Flow collections may span several lines, which must not be taken for keys
+        if (!isDocMarker(line, "---") && !isDocMarker(line, "...")) {
+            size_t flow_start = findFlowStart(line, has_alias);
+            if (flow_start != std::string_view::npos) {
+                scanFlow(line.substr(flow_start), flow, has_alias);
+            }
+        }
+        pos = next;
+    }
+    if (!is_closed) {
+        closeDocument(size);
+    }
+
+    for (auto& doc : documents_) {
+        if (!doc.is_sectioned) {
+            doc.sections.clear();
+            doc.section_ids.clear();
+        }
+    }
+}
+
+const LazyDataFile::Document& LazyDataFile::getDocumentIndex(size_t doc_index) const {
+    if (doc_index >= documents_.size()) {
+        throw std::runtime_error("Document index " + std::to_string(doc_index) +
+                                 " out of range in: " + file_path_);
+    }
+    return documents_[doc_index];
+}
+
+DataNode LazyDataFile::parseRange(size_t begin, size_t end) const {
+    DataNode node;
+    try {
+        ryml::csubstr range(content_.data() + begin, end - begin);
+        ryml::parse_in_arena(range, *node.tree_);
+        node.node_id_ = node.tree_->root_id();
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Parsing error in " + file_path_ + ": " + std::string(e.what()));
+    }
+    node.resolveIncludes(file_path_);
+    return node;
+}
+
+DataNode LazyDataFile::getParsedDocument(Document& document) {
+    if (!document.node) {
+        document.node = parseRange(document.begin, document.end);
+        ++num_parsed_;
+    }
+    return *document.node;
+}
+
+} // namespace icarus
@@ -7,17 +7,133 @@
  */
 #include "icarus/utils/logging_module.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/sinks/stdout_sinks.h"
 
 namespace icarus {
 
+namespace {
+
+/// Mode of the loggers created without an explicit mode.
+std::atomic<LogMode> default_log_mode{LogMode::kSync};
+/// Mutex protecting the configuration of the asynchronous loggers.
+std::mutex async_config_mutex;
+/// Configuration of the thread pool of the asynchronous loggers.
+AsyncLogConfig async_config;
+/**
+ * @brief Thread pool of asynchronous loggers with the loggers bound to it.
+ */
+struct AsyncPool {
+	std::shared_ptr<spdlog::details::thread_pool> thread_pool;  ///< Pool, kept alive while used.
+	std::vector<std::weak_ptr<spdlog::logger>> loggers;         ///< Loggers created with the pool.
+
+	/**
+	 * @brief Checks whether a logger still uses the pool.
+	 *
+	 * Loggers are also kept alive by their messages queued in the pool.
+	 *
+	 * @returns True if a logger of the pool is alive.
+	 */
+	bool isUsed() const {
+		return std::any_of(loggers.begin(), loggers.end(),
+		                   [](const auto& logger) { return !logger.expired(); });
+	}
+};
+/// Pool of the asynchronous loggers created from now on.
+AsyncPool current_pool;
+/// Replaced pools still used by asynchronous loggers.
+std::vector<AsyncPool> retired_pools;
+
+/**
+ * @brief Converts an overflow policy into the spdlog policy.
+ *
+ * @param policy Overflow policy.
+ * @returns spdlog overflow policy.
+ * @throws std::runtime_error If the policy is not supported by the spdlog version.
+ */
+spdlog::async_overflow_policy toSpdlogPolicy(OverflowPolicy policy) {
+	switch (policy) {
+		case OverflowPolicy::kDropOldest:
+			return spdlog::async_overflow_policy::overrun_oldest;
+		case OverflowPolicy::kDropNewest:
+			#if SPDLOG_VERSION >= 11300
+				return spdlog::async_overflow_policy::discard_new;
+			#else
+				throw std::runtime_error("The overflow policy kDropNewest requires spdlog 1.13 or newer.");
+			#endif
+		default:
+			return spdlog::async_overflow_policy::block;
+	}
+}
+
+/**
+ * @brief Creates the sink of the loggers writing to stdout.
+ *
+ * @param is_colored Flag to enable colored output.
+ * @returns Shared pointer to the sink.
+ */
+spdlog::sink_ptr createStdoutSink(bool is_colored) {
+	if (is_colored) {
+		return std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+	}
+	return std::make_shared<spdlog::sinks::stdout_sink_mt>();
+}
+
+/**
+ * @brief Creates an asynchronous logger writing to stdout and registers it.
+ *
+ * @param logger_name Name of the logger.
+ * @param is_colored Flag to enable colored output.
+ * @returns Shared pointer to the logger.
+ */
+std::shared_ptr<spdlog::logger> createAsyncLogger(const std::string& logger_name, bool is_colored) {
+	std::shared_ptr<spdlog::logger> logger;
+	{
+		// The logger only holds a weak pointer to the pool, which is therefore kept alive
+		// while the logger is, see LoggingModule::setAsyncConfig
+		std::lock_guard<std::mutex> lock(async_config_mutex);
+		spdlog::async_overflow_policy policy = toSpdlogPolicy(async_config.overflow_policy);
+		std::shared_ptr<spdlog::details::thread_pool> thread_pool = spdlog::thread_pool();
+		if (!thread_pool) {
+			spdlog::init_thread_pool(async_config.queue_size, async_config.num_threads);
+			thread_pool = spdlog::thread_pool();
+		}
+		if (current_pool.thread_pool != thread_pool) {
+			current_pool = {thread_pool, {}};  // Pool replaced via spdlog directly
+		}
+		logger = std::make_shared<spdlog::async_logger>(logger_name, createStdoutSink(is_colored),
+		                                                thread_pool, policy);
+		auto& loggers = current_pool.loggers;
+		loggers.erase(std::remove_if(loggers.begin(), loggers.end(),
+		                             [](const auto& pool_logger) { return pool_logger.expired(); }),
+		              loggers.end());
+		loggers.push_back(logger);
+	}
+	spdlog::initialize_logger(logger);
+	return logger;
+}
+
+} // namespace
+
 LoggingModule::LoggingModule(const std::string& logger_name, bool is_colored)
-		: logger_(spdlog::stdout_color_mt(logger_name)) {
-	if (!is_colored) {
-		logger_ = std::make_shared<spdlog::logger>(logger_name);
+		: LoggingModule(logger_name, is_colored, getDefaultLogMode()) {}
+
+LoggingModule::LoggingModule(const std::string& logger_name, bool is_colored, LogMode mode) {
+	if (mode == LogMode::kAsync) {
+		logger_ = createAsyncLogger(logger_name, is_colored);
+		return;
 	}
+	logger_ = std::make_shared<spdlog::logger>(logger_name, createStdoutSink(is_colored));
+	spdlog::initialize_logger(logger_);
 }
 
 LoggingModule::LoggingModule(std::shared_ptr<spdlog::logger> logger)
@@ -29,7 +145,7 @@ LoggingModule::~LoggingModule() {
 	}
 }
 
-std::shared_ptr<spdlog::logger> LoggingModule::getLogger() const {
+const std::shared_ptr<spdlog::logger>& LoggingModule::getLogger() const {
 	return logger_;
 }
 
@@ -44,10 +160,62 @@ void LoggingModule::setLogger(std::shared_ptr<spdlog::logger> logger) {
 	logger_ = logger;
 }
 
+const std::shared_ptr<BinaryLogger>& LoggingModule::getBinaryLogger() const {
+	return binary_logger_;
+}
+
+void LoggingModule::setBinaryLogger(std::shared_ptr<BinaryLogger> binary_logger) {
+	binary_logger_ = std::move(binary_logger);
+}
+
 void LoggingModule::setGlobalLogLevel(spdlog::level::level_enum level) {
 	spdlog::apply_all([&](std::shared_ptr<spdlog::logger> logger) {
 		logger->set_level(level);
 	});
 }
 
+void LoggingModule::setDefaultLogMode(LogMode mode) {
+	default_log_mode = mode;
+}
+
+LogMode LoggingModule::getDefaultLogMode() {
+	return default_log_mode;
+}
+
+void LoggingModule::setAsyncConfig(const AsyncLogConfig& config) {
+	if (config.queue_size == 0 || config.num_threads == 0) {
+		throw std::runtime_error("The queue size and the number of logging threads must be positive.");
+	}
+	toSpdlogPolicy(config.overflow_policy);  // Throws if not supported
+
+	std::lock_guard<std::mutex> lock(async_config_mutex);
+	// Existing loggers keep using the replaced pool, which is released once they are gone
+	if (current_pool.isUsed()) {
+		retired_pools.push_back(std::move(current_pool));
+	}
+	retired_pools.erase(std::remove_if(retired_pools.begin(), retired_pools.end(),
+	                                   [](const AsyncPool& pool) { return !pool.isUsed(); }),
+	                    retired_pools.end());
+	async_config = config;
+	spdlog::init_thread_pool(config.queue_size, config.num_threads);
+	current_pool = {spdlog::thread_pool(), {}};
+}
+
+AsyncLogConfig LoggingModule::getAsyncConfig() {
+	std::lock_guard<std::mutex> lock(async_config_mutex);
+	return async_config;
+}
+
+size_t LoggingModule::getNumDroppedMessages() {
+	auto thread_pool = spdlog::thread_pool();
+	if (!thread_pool) {
+		return 0;
+	}
+	size_t num_dropped = thread_pool->overrun_counter();
+	#if SPDLOG_VERSION >= 11300
+		num_dropped += thread_pool->discard_counter();
+	#endif
+	return num_dropped;
+}
+
 } // namespace icarus
@@ -0,0 +1,129 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/mapped_file.cpp
+ * @brief Implementation of the class MappedFile.
+ */
+#include "icarus/utils/mapped_file.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include <stdexcept>
+#include <utility>
+
+#include "icarus/utils/system_ops.h"
+
+namespace icarus::utils {
+
+MappedFile::MappedFile(const std::string& file_path, AccessHint hint, bool prefetch) {
+    #ifdef _WIN32
+        DWORD flags = (hint == AccessHint::kSequential) ? FILE_FLAG_SEQUENTIAL_SCAN
+                      : (hint == AccessHint::kRandom)   ? FILE_FLAG_RANDOM_ACCESS
+                                                        : FILE_ATTRIBUTE_NORMAL;
+        HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Could not open file for reading: " + file_path);
+        }
+        LARGE_INTEGER file_size;
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+            HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (file_mapping != nullptr) {
+                // The view keeps the mapping alive after the handles are closed
+                mapping_ = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(file_mapping);
+            }
+            if (mapping_ != nullptr) {
+                size_ = static_cast<size_t>(file_size.QuadPart);
+                #if _WIN32_WINNT >= 0x0602
+                    if (prefetch) {
+                        WIN32_MEMORY_RANGE_ENTRY range = {mapping_, size_};
+                        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+                    }
+                #else
+                    (void)prefetch;
+                #endif
+            }
+        }
+        CloseHandle(file);
+    #elif __linux__
+        int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error("Could not open file for reading: " + file_path);
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+            size_t size = static_cast<size_t>(file_stat.st_size);
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                mapping_ = mapping;
+                size_ = size;
+                if (hint == AccessHint::kSequential) {
+                    madvise(mapping_, size_, MADV_SEQUENTIAL);
+                }
+                else if (hint == AccessHint::kRandom) {
+                    madvise(mapping_, size_, MADV_RANDOM);
+                }
+                if (prefetch) {
+                    madvise(mapping_, size_, MADV_WILLNEED);
+                }
+            }
+        }
+        close(fd);
+    #else
+        (void)hint;
+        (void)prefetch;
+    #endif
+
+    if (mapping_ != nullptr) {
+        data_ = static_cast<const char*>(mapping_);
+    }
+    else {
+        buffer_ = getFileContent(file_path);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        buffer_ = std::move(other.buffer_);
+        // Small buffers are stored inline, so the data pointer is derived again
+        data_ = (mapping_ != nullptr) ? static_cast<const char*>(mapping_) : buffer_.data();
+        other.buffer_.clear();
+        other.data_ = "";
+    }
+    return *this;
+}
+
+void MappedFile::unmap() {
+    if (mapping_ == nullptr) {
+        return;
+    }
+    #ifdef _WIN32
+        UnmapViewOfFile(mapping_);
+    #elif __linux__
+        munmap(mapping_, size_);
+    #endif
+    mapping_ = nullptr;
+}
+
+} // namespace icarus::utils
@@ -0,0 +1,430 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/process.cpp
+ * @brief Implementation of the functions for running child processes.
+ */
+#include "icarus/utils/process.h"
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <signal.h>
+    #include <spawn.h>
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+extern char** environ;
+#endif
+
+namespace icarus::utils {
+
+namespace {
+
+#ifdef __linux__
+
+/// Minimum free space of the output buffers for each read.
+constexpr size_t kReadChunkSize = 64 * 1024;
+/// Maximum time between two checks of the cancellation flag.
+constexpr std::chrono::milliseconds kCancelCheckInterval(20);
+
+/**
+ * @brief Blocks SIGPIPE for the calling thread, so that writing to a closed stdin pipe
+ *        fails with EPIPE instead of terminating the process.
+ */
+class SigpipeBlocker {
+public:
+    SigpipeBlocker() {
+        sigemptyset(&sigpipe_set_);
+        sigaddset(&sigpipe_set_, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &sigpipe_set_, &old_set_);
+    }
+
+    ~SigpipeBlocker() {
+        // Consume a SIGPIPE raised by this thread before unblocking it
+        struct timespec zero_timeout = {0, 0};
+        while (sigtimedwait(&sigpipe_set_, nullptr, &zero_timeout) > 0) {
+        }
+        pthread_sigmask(SIG_SETMASK, &old_set_, nullptr);
+    }
+
+private:
+    sigset_t sigpipe_set_;
+    sigset_t old_set_;
+};
+
+/**
+ * @brief Pipe whose file descriptors are closed on destruction.
+ */
+struct Pipe {
+    int fds[2] = {-1, -1};  ///< Read and write end.
+
+    Pipe() {
+        if (pipe2(fds, O_CLOEXEC) == -1) {
+            throw std::runtime_error("Could not create pipe: " + std::string(std::strerror(errno)));
+        }
+    }
+
+    ~Pipe() {
+        closeEnd(0);
+        closeEnd(1);
+    }
+
+    /**
+     * @brief Closes one end of the pipe, if open.
+     *
+     * @param end 0 for the read end, 1 for the write end.
+     */
+    void closeEnd(int end) {
+        if (fds[end] != -1) {
+            close(fds[end]);
+            fds[end] = -1;
+        }
+    }
+};
+
+/**
+ * @brief Reads the available data of a pipe into a buffer.
+ *
+ * @param fd Read end of the pipe.
+ * @param buffer Buffer to append to.
+ * @returns False at the end of the stream, true otherwise.
+ */
+bool readPipe(int fd, std::string& buffer) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + std::max(kReadChunkSize, buffer.capacity() - offset));
+    ssize_t num_read = read(fd, buffer.data() + offset, buffer.size() - offset);
+    buffer.resize(offset + std::max<ssize_t>(num_read, 0));
+    if (num_read == -1) {
+        return errno == EINTR || errno == EAGAIN;
+    }
+    return num_read > 0;
+}
+
+/**
+ * @brief Redirects a standard stream of the child according to its mode.
+ *
+ * @param actions File actions of the spawn.
+ * @param mode Mode of the stream.
+ * @param pipe Pipe of a captured stream.
+ * @param std_fd Standard file descriptor to redirect (1 or 2).
+ */
+void redirectOutput(posix_spawn_file_actions_t& actions, StreamMode mode, const Pipe& pipe,
+                    int std_fd) {
+    if (mode == StreamMode::kCapture) {
+        posix_spawn_file_actions_adddup2(&actions, pipe.fds[1], std_fd);
+    }
+    else if (mode == StreamMode::kDiscard) {
+        posix_spawn_file_actions_addopen(&actions, std_fd, "/dev/null", O_WRONLY, 0);
+    }
+}
+
+#endif
+
+} // namespace
+
+ProcessResult runProcess(const std::vector<std::string>& argv, const ProcessOptions& options) {
+    if (argv.empty()) {
+        throw std::runtime_error("No program given to run.");
+    }
+
+    #ifdef __linux__
+        using Clock = std::chrono::steady_clock;
+
+        SigpipeBlocker sigpipe_blocker;
+        Pipe stdin_pipe;
+        Pipe stdout_pipe;
+        Pipe stderr_pipe;
+
+        // The duplicated descriptors lose O_CLOEXEC, the pipe ends themselves are closed on exec
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (options.stdin_data) {
+            posix_spawn_file_actions_adddup2(&actions, stdin_pipe.fds[0], STDIN_FILENO);
+        }
+        redirectOutput(actions, options.stdout_mode, stdout_pipe, STDOUT_FILENO);
+        redirectOutput(actions, options.stderr_mode, stderr_pipe, STDERR_FILENO);
+
+        // Reset the signal mask and SIGPIPE, which the child would otherwise inherit
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t signal_set;
+        sigemptyset(&signal_set);
+        posix_spawnattr_setsigmask(&attr, &signal_set);
+        sigaddset(&signal_set, SIGPIPE);
+        posix_spawnattr_setsigdefault(&attr, &signal_set);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+        std::vector<char*> argv_ptrs;
+        argv_ptrs.reserve(argv.size() + 1);
+        for (const auto& arg : argv) {
+            argv_ptrs.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv_ptrs.push_back(nullptr);
+
+        pid_t pid;
+        int spawn_error = posix_spawnp(&pid, argv[0].c_str(), &actions, &attr, argv_ptrs.data(),
+                                       environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+        if (spawn_error != 0) {
+            throw std::runtime_error("Could not start process " + argv[0] + ": " +
+                                     std::strerror(spawn_error));
+        }
+
+        stdin_pipe.closeEnd(0);
+        stdout_pipe.closeEnd(1);
+        stderr_pipe.closeEnd(1);
+        if (!options.stdin_data || options.stdin_data->empty()) {
+            stdin_pipe.closeEnd(1);
+        }
+        else {
+            fcntl(stdin_pipe.fds[1], F_SETFL, O_NONBLOCK);
+        }
+        if (options.stdout_mode != StreamMode::kCapture) {
+            stdout_pipe.closeEnd(0);
+        }
+        if (options.stderr_mode != StreamMode::kCapture) {
+            stderr_pipe.closeEnd(0);
+        }
+
+        // Serve stdin, stdout and stderr until all are closed, the timeout expires or the
+        // process is cancelled
+        ProcessResult result;
+        std::string stdout_chunk;  // Reused for all chunks passed to the stdout sink
+        std::string& stdout_buffer = options.stdout_sink ? stdout_chunk : result.stdout_data;
+        size_t stdin_offset = 0;
+        const bool has_timeout = options.timeout.count() > 0;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start + options.timeout;
+        auto stop_if_needed = [&]() {
+            if (options.cancel_flag != nullptr && options.cancel_flag->load()) {
+                result.is_cancelled = true;
+            }
+            else if (has_timeout && Clock::now() >= deadline) {
+                result.is_timed_out = true;
+            }
+            else {
+                return false;
+            }
+            kill(pid, SIGKILL);
+            return true;
+        };
+        auto get_poll_timeout = [&]() {
+            auto remaining = has_timeout ? std::chrono::duration_cast<std::chrono::milliseconds>(
+                                               deadline - Clock::now()) + std::chrono::milliseconds(1)
+                                         : std::chrono::milliseconds(-1);
+            if (options.cancel_flag != nullptr &&
+                (remaining.count() < 0 || remaining > kCancelCheckInterval)) {
+                remaining = kCancelCheckInterval;
+            }
+            return static_cast<int>(remaining.count());
+        };
+
+        while (stdin_pipe.fds[1] != -1 || stdout_pipe.fds[0] != -1 || stderr_pipe.fds[0] != -1) {
+            if (stop_if_needed()) {
+                break;
+            }
+
+            struct pollfd poll_fds[3] = {{stdin_pipe.fds[1], POLLOUT, 0},
+                                         {stdout_pipe.fds[0], POLLIN, 0},
+                                         {stderr_pipe.fds[0], POLLIN, 0}};
+            int num_ready = poll(poll_fds, 3, get_poll_timeout());
+            if (num_ready == -1 && errno != EINTR) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+                throw std::runtime_error("Could not poll the pipes of process " + argv[0]);
+            }
+            if (num_ready <= 0) {
+                continue;
+            }
+
+            if (poll_fds[0].revents != 0) {
+                const std::string& data = *options.stdin_data;
+                ssize_t num_written = write(stdin_pipe.fds[1], data.data() + stdin_offset,
+                                            data.size() - stdin_offset);
+                if (num_written > 0) {
+                    stdin_offset += static_cast<size_t>(num_written);
+                }
+                // Stop writing when done or when the child closed its stdin (EPIPE)
+                if (stdin_offset == data.size() ||
+                    (num_written == -1 && errno != EAGAIN && errno != EINTR)) {
+                    stdin_pipe.closeEnd(1);
+                }
+            }
+            if (poll_fds[1].revents != 0) {
+                if (!readPipe(stdout_pipe.fds[0], stdout_buffer)) {
+                    stdout_pipe.closeEnd(0);
+                }
+                if (options.stdout_sink && !stdout_chunk.empty()) {
+                    options.stdout_sink(stdout_chunk);
+                    stdout_chunk.clear();
+                }
+            }
+            if (poll_fds[2].revents != 0 && !readPipe(stderr_pipe.fds[0], result.stderr_data)) {
+                stderr_pipe.closeEnd(0);
+            }
+        }
+
+        // The child may keep running after closing its streams
+        int status = 0;
+        struct rusage usage = {};
+        bool is_reaped = false;
+        bool is_bounded = has_timeout || options.cancel_flag != nullptr;
+        while (is_bounded && !result.is_timed_out && !result.is_cancelled && !is_reaped) {
+            is_reaped = (wait4(pid, &status, WNOHANG, &usage) == pid);
+            if (!is_reaped && !stop_if_needed()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        while (!is_reaped && wait4(pid, &status, 0, &usage) == -1 && errno == EINTR) {
+        }
+        result.wall_time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        result.cpu_time = std::chrono::microseconds(
+            (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL +
+            usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+        if (WIFEXITED(status)) {
+            result.exit_code = WEXITSTATUS(status);
+        }
+        else if (WIFSIGNALED(status)) {
+            result.signal = WTERMSIG(status);
+        }
+        return result;
+    #else
+        (void)options;
+        throw std::runtime_error("Running processes is only supported on Linux.");
+    #endif
+}
+
+std::future<ProcessResult> runProcessAsync(std::vector<std::string> argv,
+                                           ProcessOptions options) {
+    // One thread per process, so that long-running processes do not hold up pool workers
+    return std::async(std::launch::async, [argv = std::move(argv), options = std::move(options)]() {
+        return runProcess(argv, options);
+    });
+}
+
+// ================================
+// ProcessPool class
+
+ProcessPool::ProcessPool(size_t max_jobs) {
+    if (max_jobs == 0) {
+        max_jobs = getDefaultNumJobs();
+    }
+
+    workers_.reserve(max_jobs);
+    for (size_t i = 0; i < max_jobs; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+ProcessPool::~ProcessPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ProcessPool::getDefaultNumJobs() {
+    // MAKEFLAGS holds e.g. " -j8 --jobserver-auth=3,4" or "--jobs=8"
+    const char* make_flags = std::getenv("MAKEFLAGS");
+    if (make_flags != nullptr) {
+        std::string_view flags(make_flags);
+        for (std::string_view prefix : {"-j", "--jobs="}) {
+            size_t pos = flags.find(prefix);
+            while (pos != std::string_view::npos) {
+                bool is_flag_start = (pos == 0 || flags[pos - 1] == ' ');
+                size_t num_jobs = 0;
+                auto [end, error] = std::from_chars(flags.data() + pos + prefix.size(),
+                                                    flags.data() + flags.size(), num_jobs);
+                if (is_flag_start && error == std::errc() && num_jobs > 0) {
+                    return num_jobs;
+                }
+                pos = flags.find(prefix, pos + 1);
+            }
+        }
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::future<ProcessResult> ProcessPool::submit(std::vector<std::string> argv,
+                                               ProcessOptions options) {
+    options.cancel_flag = &is_cancelling_;
+    Job job{std::move(argv), std::move(options), std::promise<ProcessResult>()};
+    std::future<ProcessResult> future = job.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push(std::move(job));
+    }
+    cv_.notify_one();
+    return future;
+}
+
+void ProcessPool::cancel() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    is_cancelling_ = true;
+    while (!jobs_.empty()) {
+        ProcessResult result;
+        result.is_cancelled = true;
+        jobs_.front().promise.set_value(std::move(result));
+        jobs_.pop();
+    }
+    done_cv_.wait(lock, [this]() { return num_running_ == 0; });
+    is_cancelling_ = false;
+}
+
+void ProcessPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return jobs_.empty() && num_running_ == 0; });
+}
+
+size_t ProcessPool::getMaxJobs() const {
+    return workers_.size();
+}
+
+void ProcessPool::run() {
+    while (true) {
+        std::optional<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return is_stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // Stopping and no jobs left
+            }
+            job.emplace(std::move(jobs_.front()));
+            jobs_.pop();
+            ++num_running_;
+        }
+
+        try {
+            job->promise.set_value(runProcess(job->argv, job->options));
+        } catch (...) {
+            job->promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --num_running_;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+} // namespace icarus::utils
@@ -0,0 +1,353 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/schema.cpp
+ * @brief Implementation of the class Schema.
+ */
+#include "icarus/utils/schema.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace icarus {
+
+namespace {
+
+/// Keys allowed in a schema node.
+const char* const kSchemaKeys[] = {
+    "type", "nullable", "required", "properties", "values",
+    "additional", "items", "min_size", "max_size", "enum"
+};
+
+bool isNullScalar(std::string_view val) {
+    return val.empty() || val == "~" || val == "null" || val == "Null" || val == "NULL";
+}
+
+bool isBoolScalar(std::string_view val) {
+    return val == "true" || val == "True" || val == "TRUE" ||
+           val == "false" || val == "False" || val == "FALSE";
+}
+
+/**
+ * @brief Consumes a sequence of digits and returns the number of consumed characters.
+ */
+size_t skipDigits(std::string_view val, size_t pos) {
+    size_t start = pos;
+    while (pos < val.size() && std::isdigit(static_cast<unsigned char>(val[pos]))) {
+        ++pos;
+    }
+    return pos - start;
+}
+
+bool isIntScalar(std::string_view val) {
+    size_t pos = (!val.empty() && (val[0] == '+' || val[0] == '-')) ? 1 : 0;
+    size_t num_digits = skipDigits(val, pos);
+    return num_digits > 0 && pos + num_digits == val.size();
+}
+
+bool isFloatScalar(std::string_view val) {
+    // YAML 1.2 core schema: infinity may be signed, NaN may not
+    if (val == ".nan" || val == ".NaN" || val == ".NAN") {
+        return true;
+    }
+    size_t pos = (!val.empty() && (val[0] == '+' || val[0] == '-')) ? 1 : 0;
+    std::string_view unsigned_val = val.substr(pos);
+    if (unsigned_val == ".inf" || unsigned_val == ".Inf" || unsigned_val == ".INF") {
+        return true;
+    }
+
+    size_t num_digits = skipDigits(val, pos);
+    pos += num_digits;
+    if (pos < val.size() && val[pos] == '.') {
+        size_t num_decimals = skipDigits(val, pos + 1);
+        pos += 1 + num_decimals;
+        num_digits += num_decimals;
+    }
+    if (num_digits == 0) {
+        return false;
+    }
+    if (pos < val.size() && (val[pos] == 'e' || val[pos] == 'E')) {
+        ++pos;
+        if (pos < val.size() && (val[pos] == '+' || val[pos] == '-')) {
+            ++pos;
+        }
+        size_t num_exp_digits = skipDigits(val, pos);
+        if (num_exp_digits == 0) {
+            return false;
+        }
+        pos += num_exp_digits;
+    }
+    return pos == val.size();
+}
+
+const char* typeName(int type) {
+    static const char* const kNames[] = {
+        "any", "map", "seq", "scalar", "str", "int", "float", "bool", "null"
+    };
+    return kNames[type];
+}
+
+/**
+ * @brief Reads a non-negative integer field of a schema node.
+ */
+size_t readSize(const DataNode& spec, const char* key, const std::string& path) {
+    std::string_view val = spec[key].getValView();
+    if (!isIntScalar(val) || val[0] == '-') {
+        throw std::runtime_error("Invalid schema at " + path + ": '" + key +
+                                 "' must be a non-negative integer.");
+    }
+    return spec[key].as<size_t>();
+}
+
+/**
+ * @brief Reads a boolean field of a schema node.
+ */
+bool readBool(const DataNode& spec, const char* key, const std::string& path) {
+    std::string_view val = spec[key].getValView();
+    if (!isBoolScalar(val)) {
+        throw std::runtime_error("Invalid schema at " + path + ": '" + key +
+                                 "' must be a boolean.");
+    }
+    return val[0] == 't' || val[0] == 'T';
+}
+
+} // namespace
+
+Schema::Schema(const DataNode& spec) {
+    compileRule(spec, "$");
+}
+
+Schema::Schema(const std::string& file_path)
+        : Schema(DataNode(file_path)) {}
+
+std::vector<Schema::Violation> Schema::validate(const DataNode& document) const {
+    Context ctx;
+    ctx.path = "$";
+
+    if (!document.isValid()) {
+        addViolation(ctx, "Document is invalid.");
+        return ctx.violations;
+    }
+
+    validateNode(document, 0, ctx);
+    return ctx.violations;
+}
+
+bool Schema::isValid(const DataNode& document) const {
+    return validate(document).empty();
+}
+
+size_t Schema::compileRule(const DataNode& spec, const std::string& path) {
+    // Reserve the index first, as compiling children appends further rules
+    size_t rule_id = rules_.size();
+    rules_.emplace_back();
+    Rule rule;
+
+    if (spec.isVal() || spec.isKeyVal()) {
+        // An empty schema node (e.g., "key: ~") accepts any value
+        if (!isNullScalar(spec.getValView())) {
+            throw std::runtime_error("Invalid schema at " + path + ": expected a map.");
+        }
+        return rule_id;
+    }
+    if (!spec.isMap()) {
+        throw std::runtime_error("Invalid schema at " + path + ": expected a map.");
+    }
+
+    for (const auto& field : spec) {
+        std::string_view key = field.getKeyView();
+        if (std::find(std::begin(kSchemaKeys), std::end(kSchemaKeys), key) ==
+            std::end(kSchemaKeys)) {
+            throw std::runtime_error("Invalid schema at " + path + ": unknown key '" +
+                                     std::string(key) + "'.");
+        }
+    }
+
+    if (spec.hasChild("type")) {
+        std::string_view type = spec["type"].getValView();
+        int type_id = 0;
+        for (; type_id <= static_cast<int>(ValueType::kNull); ++type_id) {
+            if (type == typeName(type_id)) {
+                break;
+            }
+        }
+        if (type_id > static_cast<int>(ValueType::kNull)) {
+            throw std::runtime_error("Invalid schema at " + path + ": unknown type '" +
+                                     std::string(type) + "'.");
+        }
+        rule.type = static_cast<ValueType>(type_id);
+    }
+
+    if (spec.hasChild("nullable")) {
+        rule.is_nullable = readBool(spec, "nullable", path);
+    }
+    if (spec.hasChild("additional")) {
+        rule.allow_additional = readBool(spec, "additional", path);
+    }
+    if (spec.hasChild("min_size")) {
+        rule.min_size = readSize(spec, "min_size", path);
+    }
+    if (spec.hasChild("max_size")) {
+        rule.max_size = readSize(spec, "max_size", path);
+    }
+
+    if (spec.hasChild("enum")) {
+        DataNode enum_node = spec["enum"];
+        if (!enum_node.isSeq()) {
+            throw std::runtime_error("Invalid schema at " + path + ": 'enum' must be a sequence.");
+        }
+        rule.enum_values = enum_node.getSeqStrings();
+    }
+
+    // Listed properties, sorted by key for binary search during validation
+    std::vector<std::pair<std::string, size_t>> properties;
+    if (spec.hasChild("properties")) {
+        DataNode properties_node = spec["properties"];
+        if (!properties_node.isMap()) {
+            throw std::runtime_error("Invalid schema at " + path +
+                                     ": 'properties' must be a map.");
+        }
+        for (const auto& property : properties_node) {
+            std::string key = property.getKey();
+            properties.emplace_back(key, compileRule(property, path + "." + key));
+        }
+    }
+
+    std::vector<std::string> required_keys;
+    if (spec.hasChild("required")) {
+        DataNode required_node = spec["required"];
+        if (!required_node.isSeq()) {
+            throw std::runtime_error("Invalid schema at " + path +
+                                     ": 'required' must be a sequence.");
+        }
+        required_keys = required_node.getSeqStrings();
+
+        // Required keys without an explicit schema accept any value
+        for (const auto& key : required_keys) {
+            auto it = std::find_if(properties.begin(), properties.end(),
+                                   [&key](const auto& property) { return property.first == key; });
+            if (it == properties.end()) {
+                size_t any_rule = rules_.size();
+                rules_.emplace_back();
+                properties.emplace_back(key, any_rule);
+            }
+        }
+    }
+
+    std::sort(properties.begin(), properties.end());
+    for (auto& [key, property_rule] : properties) {
+        rule.property_keys.push_back(std::move(key));
+        rule.property_rules.push_back(property_rule);
+    }
+    for (const auto& key : required_keys) {
+        auto it = std::lower_bound(rule.property_keys.begin(), rule.property_keys.end(), key);
+        rule.required.push_back(static_cast<size_t>(it - rule.property_keys.begin()));
+    }
+
+    if (spec.hasChild("values")) {
+        rule.values_rule = compileRule(spec["values"], path + ".*");
+    }
+    if (spec.hasChild("items")) {
+        rule.items_rule = compileRule(spec["items"], path + "[*]");
+    }
+
+    rules_[rule_id] = std::move(rule);
+    return rule_id;
+}
+
+void Schema::validateNode(const DataNode& node, size_t rule_id, Context& ctx) const {
+    const Rule& rule = rules_[rule_id];
+    bool is_scalar = node.isVal() || node.isKeyVal();
+    std::string_view val = is_scalar ? node.getValView() : std::string_view();
+    bool is_null = is_scalar && isNullScalar(val);
+
+    if (is_null && rule.is_nullable) {
+        return;
+    }
+
+    // Type check
+    bool is_type_ok = true;
+    switch (rule.type) {
+        case ValueType::kAny:    is_type_ok = true; break;
+        case ValueType::kMap:    is_type_ok = node.isMap(); break;
+        case ValueType::kSeq:    is_type_ok = node.isSeq(); break;
+        case ValueType::kScalar: is_type_ok = is_scalar; break;
+        case ValueType::kStr:    is_type_ok = is_scalar && !is_null; break;
+        case ValueType::kInt:    is_type_ok = is_scalar && isIntScalar(val); break;
+        case ValueType::kFloat:  is_type_ok = is_scalar && isFloatScalar(val); break;
+        case ValueType::kBool:   is_type_ok = is_scalar && isBoolScalar(val); break;
+        case ValueType::kNull:   is_type_ok = is_null; break;
+    }
+    if (!is_type_ok) {
+        addViolation(ctx, std::string("Expected type '") +
+                          typeName(static_cast<int>(rule.type)) + "'.");
+        return;
+    }
+
+    if (is_scalar) {
+        if (!rule.enum_values.empty() &&
+            std::find(rule.enum_values.begin(), rule.enum_values.end(), val) ==
+            rule.enum_values.end()) {
+            addViolation(ctx, "Value '" + std::string(val) + "' is not one of the allowed values.");
+        }
+        return;
+    }
+
+    // Children of maps and sequences
+    size_t path_len = ctx.path.size();
+    size_t num_children = 0;
+
+    if (node.isMap()) {
+        size_t seen_base = ctx.seen.size();
+        ctx.seen.resize(seen_base + rule.property_keys.size(), 0);
+
+        for (const auto& child : node) {
+            ++num_children;
+            std::string_view key = child.getKeyView();
+            ctx.path.append(1, '.').append(key);
+
+            auto it = std::lower_bound(rule.property_keys.begin(), rule.property_keys.end(), key,
+                                       [](const std::string& a, std::string_view b) { return a < b; });
+            if (it != rule.property_keys.end() && *it == key) {
+                size_t property_id = static_cast<size_t>(it - rule.property_keys.begin());
+                ctx.seen[seen_base + property_id] = 1;
+                validateNode(child, rule.property_rules[property_id], ctx);
+            } else if (rule.values_rule != SIZE_MAX) {
+                validateNode(child, rule.values_rule, ctx);
+            } else if (!rule.allow_additional) {
+                addViolation(ctx, "Unexpected key.");
+            }
+
+            ctx.path.resize(path_len);
+        }
+
+        for (size_t property_id : rule.required) {
+            if (!ctx.seen[seen_base + property_id]) {
+                addViolation(ctx, "Missing required key '" + rule.property_keys[property_id] + "'.");
+            }
+        }
+        ctx.seen.resize(seen_base);
+    } else if (node.isSeq()) {
+        for (const auto& child : node) {
+            if (rule.items_rule != SIZE_MAX) {
+                ctx.path.append(1, '[').append(std::to_string(num_children)).append(1, ']');
+                validateNode(child, rule.items_rule, ctx);
+                ctx.path.resize(path_len);
+            }
+            ++num_children;
+        }
+    }
+
+    if (num_children < rule.min_size || num_children > rule.max_size) {
+        addViolation(ctx, "Number of children (" + std::to_string(num_children) +
+                          ") is out of bounds.");
+    }
+}
+
+void Schema::addViolation(Context& ctx, std::string message) {
+    ctx.violations.push_back({ctx.path, std::move(message)});
+}
+
+} // namespace icarus
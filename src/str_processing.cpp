@@ -8,45 +8,486 @@
 #include "icarus/utils/str_processing.h"
 
 #include <algorithm>
-#include <iostream>
-#include <sstream>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "icarus/utils/indented_writer.h"
+
+// SIMD scanning on x86 (SSE2 is part of x86-64, AVX2 is selected at runtime)
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ICARUS_STR_X86
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define ICARUS_TARGET_AVX2
+    #else
+        #define ICARUS_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+    #include <immintrin.h>
+#endif
 
 namespace icarus::utils {
 
-std::string trimStr(const std::string& str) {
-    // Find the first non-whitespace character
-    size_t first = str.find_first_not_of(' ');
-    if (first == std::string::npos) {
-        return "";
+namespace {
+
+/// Minimum number of slots of a non-empty StringSet.
+constexpr size_t kMinSlots = 16;
+/// Maximum number of strings to remove by linear search instead of hashing.
+constexpr size_t kMaxLinearRemove = 8;
+
+/// Character class of ASCII whitespaces (space, \t, \n, \v, \f, \r).
+constexpr uint8_t kSpace = 1;
+/// Character class of identifier characters (ASCII letters, digits, '_' and '-').
+constexpr uint8_t kIdent = 2;
+
+/**
+ * @brief Builds the locale-independent table of character classes.
+ */
+constexpr std::array<uint8_t, 256> makeCharTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = '\t'; c <= '\r'; ++c) {
+        table[c] = kSpace;
+    }
+    table[' '] = kSpace;
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = kIdent;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table[c] = kIdent;
+        table[c - 'a' + 'A'] = kIdent;
+    }
+    table['_'] = kIdent;
+    table['-'] = kIdent;
+    return table;
+}
+
+/// Character classes of all byte values.
+constexpr std::array<uint8_t, 256> kCharTable = makeCharTable();
+
+/**
+ * @brief Checks whether a character belongs to a character class.
+ */
+inline bool isCharOf(char c, uint8_t char_class) {
+    return (kCharTable[static_cast<unsigned char>(c)] & char_class) != 0;
+}
+
+/// Function scanning a buffer for a character (class).
+using ScanFunction = bool (*)(const char*, size_t);
+
+/**
+ * @brief Scan functions of the instruction set selected at runtime.
+ */
+struct ScanFunctions {
+    ScanFunction find_space;    ///< Finds a whitespace.
+    ScanFunction find_special;  ///< Finds a non-identifier character.
+};
+
+bool findSpaceScalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (isCharOf(data[i], kSpace)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool findSpecialScalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (!isCharOf(data[i], kIdent)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef ICARUS_STR_X86
+// The same range checks are used for 16 (SSE2) and 32 (AVX2) bytes: a byte c is in the
+// range [lo, lo + n] if the unsigned minimum of (c - lo) and n equals (c - lo).
+
+bool findSpaceSse2(const char* data, size_t size) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i ctrl_range = _mm_set1_epi8('\r' - '\t');
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i ctrl = _mm_sub_epi8(v, tab);
+        __m128i is_space = _mm_or_si128(
+            _mm_cmpeq_epi8(v, space),
+            _mm_cmpeq_epi8(_mm_min_epu8(ctrl, ctrl_range), ctrl));
+        if (_mm_movemask_epi8(is_space) != 0) {
+            return true;
+        }
+    }
+    return findSpaceScalar(data + i, size - i);
+}
+
+bool findSpecialSse2(const char* data, size_t size) {
+    const __m128i digit_lo = _mm_set1_epi8('0');
+    const __m128i digit_range = _mm_set1_epi8(9);
+    const __m128i alpha_lo = _mm_set1_epi8('a');
+    const __m128i alpha_range = _mm_set1_epi8(25);
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i underscore = _mm_set1_epi8('_');
+    const __m128i hyphen = _mm_set1_epi8('-');
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i digit = _mm_sub_epi8(v, digit_lo);
+        __m128i alpha = _mm_sub_epi8(_mm_or_si128(v, case_bit), alpha_lo);
+        __m128i is_ident = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(digit, digit_range), digit),
+                         _mm_cmpeq_epi8(_mm_min_epu8(alpha, alpha_range), alpha)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, underscore), _mm_cmpeq_epi8(v, hyphen)));
+        if (_mm_movemask_epi8(is_ident) != 0xFFFF) {
+            return true;
+        }
+    }
+    return findSpecialScalar(data + i, size - i);
+}
+
+ICARUS_TARGET_AVX2 bool findSpaceAvx2(const char* data, size_t size) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i ctrl_range = _mm256_set1_epi8('\r' - '\t');
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i ctrl = _mm256_sub_epi8(v, tab);
+        __m256i is_space = _mm256_or_si256(
+            _mm256_cmpeq_epi8(v, space),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(ctrl, ctrl_range), ctrl));
+        if (_mm256_movemask_epi8(is_space) != 0) {
+            return true;
+        }
+    }
+    return findSpaceSse2(data + i, size - i);
+}
+
+ICARUS_TARGET_AVX2 bool findSpecialAvx2(const char* data, size_t size) {
+    const __m256i digit_lo = _mm256_set1_epi8('0');
+    const __m256i digit_range = _mm256_set1_epi8(9);
+    const __m256i alpha_lo = _mm256_set1_epi8('a');
+    const __m256i alpha_range = _mm256_set1_epi8(25);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i underscore = _mm256_set1_epi8('_');
+    const __m256i hyphen = _mm256_set1_epi8('-');
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i digit = _mm256_sub_epi8(v, digit_lo);
+        __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(v, case_bit), alpha_lo);
+        __m256i is_ident = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(digit, digit_range), digit),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, alpha_range), alpha)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, underscore), _mm256_cmpeq_epi8(v, hyphen)));
+        if (_mm256_movemask_epi8(is_ident) != -1) {
+            return true;
+        }
+    }
+    return findSpecialSse2(data + i, size - i);
+}
+
+/**
+ * @brief Checks whether the CPU and the operating system support AVX2.
+ */
+bool hasAvx2() {
+    #ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool has_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+        if (!has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+}
+#endif
+
+/**
+ * @brief Selects the scan functions for the instruction sets of the CPU (once).
+ */
+const ScanFunctions& getScanFunctions() {
+    static const ScanFunctions functions = []() -> ScanFunctions {
+        #ifdef ICARUS_STR_X86
+            if (hasAvx2()) {
+                return {findSpaceAvx2, findSpecialAvx2};
+            }
+            return {findSpaceSse2, findSpecialSse2};
+        #else
+            return {findSpaceScalar, findSpecialScalar};
+        #endif
+    }();
+    return functions;
+}
+
+} // namespace
+
+std::string trimStr(std::string_view str) {
+    return std::string(trimStrView(str));
+}
+
+std::string_view trimStrView(std::string_view str) {
+    size_t first = 0;
+    size_t last = str.size();
+    while (first < last && isCharOf(str[first], kSpace)) {
+        ++first;
     }
+    while (last > first && isCharOf(str[last - 1], kSpace)) {
+        --last;
+    }
+    return str.substr(first, last - first);
+}
+
+bool containsWhitespace(std::string_view str) {
+    return getScanFunctions().find_space(str.data(), str.size());
+}
 
-    size_t last = str.find_last_not_of(' ');
-    return str.substr(first, last - first + 1);
+std::vector<bool> containsWhitespace(const std::vector<std::string>& strs) {
+    const ScanFunctions& functions = getScanFunctions();
+    std::vector<bool> results(strs.size());
+    for (size_t i = 0; i < strs.size(); ++i) {
+        results[i] = functions.find_space(strs[i].data(), strs[i].size());
+    }
+    return results;
 }
 
-bool containsWhitespace(const std::string& str) {
-    // Find any whitespace character that is not at the beginning or end of the string
-    auto it = std::find_if(str.begin(), str.end(), [](unsigned char ch) {
-        return std::isspace(ch);
-        });
+bool containsSpecialChars(std::string_view str) {
+    return getScanFunctions().find_special(str.data(), str.size());
+}
 
-    return it != str.end();
+std::vector<bool> containsSpecialChars(const std::vector<std::string>& strs) {
+    const ScanFunctions& functions = getScanFunctions();
+    std::vector<bool> results(strs.size());
+    for (size_t i = 0; i < strs.size(); ++i) {
+        results[i] = functions.find_special(strs[i].data(), strs[i].size());
+    }
+    return results;
 }
 
-bool containsSpecialChars(const std::string& str) {
-    return std::find_if(str.begin(), str.end(), [](unsigned char ch) {
-        // Allow letters, digits, and underscores
-        return !(std::isalnum(ch) || ch == '_' || ch == '-');
-        }) != str.end();
+// ================================
+// StringSet class
+// ================================
+
+StringSet::StringSet(const std::vector<std::string>& strs) {
+    reserve(strs.size());
+    for (const auto& str : strs) {
+        insert(str);
+    }
 }
 
+bool StringSet::insert(std::string_view str) {
+    if (2 * (strings_.size() + 1) > slots_.size()) {
+        rehash(std::max<size_t>(kMinSlots, 2 * slots_.size()));
+    }
+
+    uint64_t hash = hashString(str);
+    size_t slot = findSlot(str, hash);
+    if (slots_[slot].index != 0) {
+        return false;
+    }
+    strings_.emplace_back(str);
+    hashes_.push_back(hash);
+    slots_[slot] = {hash, static_cast<uint32_t>(strings_.size())};
+    return true;
+}
+
+size_t StringSet::find(std::string_view str) const {
+    if (strings_.empty()) {
+        return npos;
+    }
+    size_t slot = findSlot(str, hashString(str));
+    return (slots_[slot].index == 0) ? npos : slots_[slot].index - 1;
+}
+
+void StringSet::reserve(size_t num_strings) {
+    size_t num_slots = kMinSlots;
+    while (num_slots < 2 * num_strings) {
+        num_slots *= 2;
+    }
+    if (num_slots > slots_.size()) {
+        rehash(num_slots);
+    }
+    strings_.reserve(num_strings);
+    hashes_.reserve(num_strings);
+}
+
+void StringSet::clear() {
+    strings_.clear();
+    hashes_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot());
+}
+
+uint64_t StringSet::hashString(std::string_view str) {
+    // Multiply-xorshift over 8-byte words, finalized with the MurmurHash3 mixer
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15ull;
+    const char* data = str.data();
+    size_t size = str.size();
+    uint64_t hash = size * kMul;
+
+    for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = (hash ^ word) * kMul;
+        hash ^= hash >> 29;
+    }
+    if (size > 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, size);
+        hash = (hash ^ word) * kMul;
+        hash ^= hash >> 29;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t StringSet::findSlot(std::string_view str, uint64_t hash) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const Slot& entry = slots_[slot];
+        if (entry.index == 0 || (entry.hash == hash && strings_[entry.index - 1] == str)) {
+            return slot;
+        }
+    }
+}
+
+void StringSet::rehash(size_t num_slots) {
+    slots_.assign(num_slots, Slot());
+    size_t mask = num_slots - 1;
+    for (size_t i = 0; i < strings_.size(); ++i) {
+        size_t slot = hashes_[i] & mask;
+        while (slots_[slot].index != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = {hashes_[i], static_cast<uint32_t>(i + 1)};
+    }
+}
+
+// End StringSet class ============
+
 bool isInVector(const std::string& str, const std::vector<std::string>& str_vec) {
     return std::find(str_vec.begin(), str_vec.end(), str) != str_vec.end();
 }
 
+bool isInVector(std::string_view str, const StringSet& str_set) {
+    return str_set.contains(str);
+}
+
+// ================================
+// SplitRange class
+// ================================
+
+SplitRange::SplitRange(std::string_view str, char delimiter)
+        : str_(str), delimiter_char_(delimiter), mode_(Mode::kChar) {}
+
+SplitRange::SplitRange(std::string_view str, std::string_view delimiter)
+        : str_(str), delimiter_(delimiter), mode_(Mode::kString) {}
+
+SplitRange SplitRange::anyOf(std::string_view str, std::string_view delimiters) {
+    SplitRange range(str, delimiters);
+    range.mode_ = Mode::kAnyOf;
+    return range;
+}
+
+SplitRange SplitRange::trim() const {
+    SplitRange range = *this;
+    range.is_trimmed_ = true;
+    return range;
+}
+
+SplitRange SplitRange::skipEmpty() const {
+    SplitRange range = *this;
+    range.skips_empty_ = true;
+    return range;
+}
+
+SplitRange SplitRange::maxSplits(size_t max_splits) const {
+    SplitRange range = *this;
+    range.max_splits_ = max_splits;
+    return range;
+}
+
+SplitRange::Iterator SplitRange::begin() const {
+    return Iterator(*this, false);
+}
+
+SplitRange::Iterator SplitRange::end() const {
+    return Iterator(*this, true);
+}
+
+std::vector<std::string_view> SplitRange::toVector() const {
+    return std::vector<std::string_view>(begin(), end());
+}
+
+size_t SplitRange::findDelimiter(size_t pos, size_t& length) const {
+    switch (mode_) {
+        case Mode::kChar:
+            length = 1;
+            return str_.find(delimiter_char_, pos);
+        case Mode::kString:
+            length = delimiter_.size();
+            return delimiter_.empty() ? std::string_view::npos : str_.find(delimiter_, pos);
+        case Mode::kAnyOf:
+            length = 1;
+            return str_.find_first_of(delimiter_, pos);
+    }
+    return std::string_view::npos;
+}
+
+SplitRange::Iterator::Iterator(const SplitRange& range, bool is_end)
+        : range_(range), is_end_(is_end) {
+    if (!is_end_) {
+        ++*this;
+    }
+}
+
+SplitRange::Iterator& SplitRange::Iterator::operator++() {
+    while (true) {
+        if (next_pos_ == std::string_view::npos) {
+            is_end_ = true;
+            return *this;
+        }
+
+        size_t start = next_pos_;
+        size_t length = 0;
+        size_t found = (num_tokens_ == range_.max_splits_) ? std::string_view::npos
+                                                           : range_.findDelimiter(start, length);
+        if (found == std::string_view::npos) {
+            token_ = range_.str_.substr(start);
+            next_pos_ = std::string_view::npos;
+        } else {
+            token_ = range_.str_.substr(start, found - start);
+            next_pos_ = found + length;
+        }
+
+        if (range_.is_trimmed_) {
+            token_ = trimStrView(token_);
+        }
+        if (!range_.skips_empty_ || !token_.empty()) {
+            ++num_tokens_;
+            return *this;
+        }
+    }
+}
+
+// End SplitRange class ===========
+
 std::pair<std::string, std::string> splitString(const std::string& input, 
                                                 const char* delimiter) {
-    // Find the position of the delimiter character
+    // Find the position of the delimiter
     size_t pos = input.find(delimiter);
 
     // Handle error: no delimiter found in the string
@@ -54,15 +495,19 @@ std::pair<std::string, std::string> splitString(const std::string& input,
         return std::make_pair("", "");
     }
 
-    // Extract the parts before and after the delimiter
+    // Extract the parts before and after the (possibly multi-character) delimiter
     std::string port_name = input.substr(0, pos);
-    std::string field_name = input.substr(pos + 1);
+    std::string field_name = input.substr(pos + std::strlen(delimiter));
 
     return std::make_pair(port_name, field_name);
 }
 
 void removeStringsFromVector(std::vector<std::string>& source, 
                              const std::vector<std::string>& to_remove) {
+    if (to_remove.size() > kMaxLinearRemove) {
+        removeStringsFromVector(source, StringSet(to_remove));
+        return;
+    }
     source.erase(
         std::remove_if(source.begin(), source.end(), [&to_remove](const std::string& str) {
             return std::find(to_remove.begin(), to_remove.end(), str) != to_remove.end();
@@ -71,19 +516,25 @@ void removeStringsFromVector(std::vector<std::string>& source,
     );
 }
 
+void removeStringsFromVector(std::vector<std::string>& source, const StringSet& to_remove) {
+    source.erase(
+        std::remove_if(source.begin(), source.end(), [&to_remove](const std::string& str) {
+            return to_remove.contains(str);
+            }),
+        source.end()
+    );
+}
+
 void printIndentedString(const std::string& message, const std::string& indent) {
-    std::istringstream stream(message);
-    std::string line;
-    bool first_line = true;
-
-    while (std::getline(stream, line)) {
-        if (first_line) {
-            std::cout << indent << line << std::endl;
-            first_line = false;
-        } else {
-            std::cout << std::string(indent.size(), ' ') << line << std::endl;
-        }
+    // Hanging indentation: the indent string on the first line, blanks on the others
+    IndentedWriter writer = IndentedWriter::toFile(stdout);
+    writer.pushIndent(indent, true);
+    writer.write(message);
+    if (!message.empty() && message.back() != '\n') {
+        writer.write("\n");
     }
+    writer.flush();
+    std::fflush(stdout);
 }
 
 } // namespace icarus::utils
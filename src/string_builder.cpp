@@ -0,0 +1,93 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/string_builder.cpp
+ * @brief Implementation of the class StringBuilder.
+ */
+#include "icarus/utils/string_builder.h"
+
+#include <algorithm>
+
+namespace icarus::utils {
+
+StringBuilder::StringBuilder(size_t chunk_size) : chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+StringBuilder& StringBuilder::append(std::string_view str) {
+    if (str.empty()) {
+        return *this;
+    }
+    getChunk(str.size()).append(str);
+    size_ += str.size();
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(char c) {
+    getChunk(1).push_back(c);
+    ++size_;
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(std::string&& str) {
+    // Small strings are cheaper to copy than to keep as chunks of their own
+    if (str.size() < chunk_size_ / 4) {
+        return append(std::string_view(str));
+    }
+    size_ += str.size();
+    if (!chunks_.empty() && chunks_.back().empty()) {
+        chunks_.back() = std::move(str);
+    }
+    else {
+        chunks_.push_back(std::move(str));
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendFile(const std::string& file_path) {
+    std::string content;
+    appendFileContent(file_path, content);
+    return append(std::move(content));
+}
+
+void StringBuilder::reserve(size_t num_bytes) {
+    if (chunks_.empty() || chunks_.back().capacity() - chunks_.back().size() < num_bytes) {
+        chunks_.emplace_back();
+        chunks_.back().reserve(std::max(num_bytes, chunk_size_));
+    }
+}
+
+std::vector<std::string_view> StringBuilder::getBuffers() const {
+    std::vector<std::string_view> buffers;
+    buffers.reserve(chunks_.size());
+    for (const auto& chunk : chunks_) {
+        if (!chunk.empty()) {
+            buffers.emplace_back(chunk);
+        }
+    }
+    return buffers;
+}
+
+std::string StringBuilder::toString() const {
+    std::string str;
+    str.reserve(size_);
+    for (const auto& chunk : chunks_) {
+        str.append(chunk);
+    }
+    return str;
+}
+
+bool StringBuilder::writeToFile(const std::string& file_path, WriteMode mode) const {
+    return writeBuffersToFile(getBuffers(), file_path, mode);
+}
+
+void StringBuilder::clear() {
+    chunks_.clear();
+    size_ = 0;
+}
+
+std::string& StringBuilder::getChunk(size_t num_bytes) {
+    reserve(num_bytes);
+    return chunks_.back();
+}
+
+} // namespace icarus::utils
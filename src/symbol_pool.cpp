@@ -0,0 +1,145 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/symbol_pool.cpp
+ * @brief Implementation of the classes Symbol and SymbolPool.
+ */
+#include "icarus/utils/symbol_pool.h"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "icarus/utils/str_processing.h"
+
+namespace icarus::utils {
+
+// ================================
+// Symbol class
+
+const Symbol::Entry Symbol::kEmptyEntry = {0, 0, ""};
+
+Symbol::Symbol() : entry_(&kEmptyEntry) {}
+
+Symbol::Symbol(std::string_view str) : entry_(SymbolPool::getGlobal().intern(str).entry_) {}
+
+// ================================
+// SymbolPool class
+
+SymbolPool& SymbolPool::getGlobal() {
+    // Never destroyed, so that symbols stay valid in static destructors
+    static SymbolPool* pool = new SymbolPool();
+    return *pool;
+}
+
+Symbol SymbolPool::intern(std::string_view str) {
+    if (str.empty()) {
+        return Symbol();
+    }
+
+    uint64_t hash = StringSet::hashString(str);
+    uint32_t shard_id = static_cast<uint32_t>(hash >> (64 - kShardBits));
+    Shard& shard = shards_[shard_id];
+
+    // Fast path: the string is already interned
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.symbols.find(str);
+        if (it != shard.symbols.end()) {
+            return Symbol(it->second);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.symbols.find(str);  // May have been added in the meantime
+    if (it != shard.symbols.end()) {
+        return Symbol(it->second);
+    }
+
+    size_t local_id = shard.entries.size() + 1;
+    if (local_id >= (size_t{1} << (32 - kShardBits)) || str.size() > UINT32_MAX) {
+        throw std::runtime_error("The symbol pool exceeds its size limits.");
+    }
+    const char* data = storeString(shard, str);
+    shard.entries.push_back({static_cast<uint32_t>((local_id << kShardBits) | shard_id),
+                             static_cast<uint32_t>(str.size()), data});
+    const Symbol::Entry* entry = &shard.entries.back();
+    shard.symbols.emplace(std::string_view(data, str.size()), entry);
+    return Symbol(entry);
+}
+
+std::vector<Symbol> SymbolPool::intern(const std::vector<std::string>& strings) {
+    std::vector<Symbol> symbols;
+    symbols.reserve(strings.size());
+    for (const auto& str : strings) {
+        symbols.push_back(intern(str));
+    }
+    return symbols;
+}
+
+std::optional<Symbol> SymbolPool::find(std::string_view str) const {
+    if (str.empty()) {
+        return Symbol();
+    }
+
+    uint64_t hash = StringSet::hashString(str);
+    const Shard& shard = shards_[hash >> (64 - kShardBits)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.symbols.find(str);
+    if (it == shard.symbols.end()) {
+        return std::nullopt;
+    }
+    return Symbol(it->second);
+}
+
+Symbol SymbolPool::getSymbol(uint32_t id) const {
+    if (id == 0) {
+        return Symbol();
+    }
+
+    const Shard& shard = shards_[id & (kNumShards - 1)];
+    size_t local_id = id >> kShardBits;
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    if (local_id == 0 || local_id > shard.entries.size()) {
+        throw std::runtime_error("The symbol ID " + std::to_string(id) + " is unknown.");
+    }
+    return Symbol(&shard.entries[local_id - 1]);
+}
+
+size_t SymbolPool::size() const {
+    size_t num_symbols = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        num_symbols += shard.entries.size();
+    }
+    return num_symbols;
+}
+
+size_t SymbolPool::Hasher::operator()(std::string_view str) const {
+    return static_cast<size_t>(StringSet::hashString(str));
+}
+
+const char* SymbolPool::storeString(Shard& shard, std::string_view str) {
+    size_t size = str.size() + 1;
+    char* data;
+    if (size > kBlockSize / 4) {
+        // Large strings get their own block, the current arena block stays in use
+        shard.blocks.push_back(std::make_unique<char[]>(size));
+        data = shard.blocks.back().get();
+    }
+    else {
+        if (shard.block_used + size > kBlockSize) {
+            shard.blocks.push_back(std::make_unique<char[]>(kBlockSize));
+            shard.block = shard.blocks.back().get();
+            shard.block_used = 0;
+        }
+        data = shard.block + shard.block_used;
+        shard.block_used += size;
+    }
+    std::memcpy(data, str.data(), str.size());
+    data[str.size()] = '\0';
+    return data;
+}
+
+} // namespace icarus::utils
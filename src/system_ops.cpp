@@ -10,17 +10,202 @@
 #ifdef _WIN32
     #include <windows.h>
 #elif __linux__
+	#include <fcntl.h>
 	#include <limits.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
 	#include <unistd.h>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <queue>
 #include <stdexcept>
 
+#include "icarus/utils/process.h"
+#include "icarus/utils/thread_pool.h"
+
 namespace fs = std::filesystem;
 
 namespace icarus::utils {
 
+namespace {
+
+/// Size of the blocks read when comparing file contents.
+constexpr size_t kCompareBlockSize = 64 * 1024;
+/// Size of the blocks read from files of unknown or changing size.
+constexpr size_t kReadBlockSize = 1024 * 1024;
+
+/**
+ * @brief Returns the ID of the current process.
+ *
+ * @returns Process ID.
+ */
+unsigned long getProcessId() {
+    #ifdef _WIN32
+        return static_cast<unsigned long>(GetCurrentProcessId());
+    #else
+        return static_cast<unsigned long>(getpid());
+    #endif
+}
+
+/**
+ * @brief Checks whether a file exists and has exactly the content of the given buffers.
+ *
+ * The sizes are compared first, so that differing files are usually detected without
+ * reading them. Otherwise, the file is compared block by block.
+ *
+ * @param buffers Buffers whose concatenation is the expected content.
+ * @param file_path Path of the file to compare.
+ * @returns True if the file content equals the buffers, false otherwise.
+ */
+bool hasFileContent(const std::vector<std::string_view>& buffers, const std::string& file_path) {
+    size_t total_size = 0;
+    for (const auto& buffer : buffers) {
+        total_size += buffer.size();
+    }
+
+    std::error_code error;
+    uintmax_t file_size = fs::file_size(file_path, error);
+    if (error) {
+        return false;
+    }
+    #ifndef _WIN32
+        // Text mode does not translate line endings, so the sizes must match
+        if (file_size != total_size) {
+            return false;
+        }
+    #endif
+
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string block(kCompareBlockSize, '\0');
+    for (const auto& buffer : buffers) {
+        for (size_t pos = 0; pos < buffer.size(); pos += kCompareBlockSize) {
+            size_t length = std::min(kCompareBlockSize, buffer.size() - pos);
+            file.read(block.data(), static_cast<std::streamsize>(length));
+            if (static_cast<size_t>(file.gcount()) != length ||
+                    block.compare(0, length, buffer.data() + pos, length) != 0) {
+                return false;
+            }
+        }
+    }
+    return file.peek() == std::ifstream::traits_type::eof();
+}
+
+/**
+ * @brief Writes the concatenation of several buffers to a file, truncating it.
+ *
+ * @param buffers Buffers to write in order.
+ * @param file_path Path of the file to write.
+ * @param replaced_path [opt] Path of the file replaced by a temporary file (empty: none).
+ *     Its permissions are applied to the written file, which is synced to the disk.
+ */
+void writeBuffers(const std::vector<std::string_view>& buffers, const std::string& file_path,
+                  const std::string& replaced_path = "") {
+    #ifdef __linux__
+        // The permissions of new files are left to the umask, like for std::ofstream
+        int fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1) {
+            throw std::runtime_error("Could not open file for writing: " + file_path);
+        }
+
+        std::vector<iovec> iovs;
+        iovs.reserve(buffers.size());
+        for (const auto& buffer : buffers) {
+            if (!buffer.empty()) {
+                iovs.push_back({const_cast<char*>(buffer.data()), buffer.size()});
+            }
+        }
+
+        // writev may write partially and accepts at most IOV_MAX buffers per call
+        size_t first = 0;
+        while (first < iovs.size()) {
+            int num_iovs = static_cast<int>(std::min<size_t>(iovs.size() - first, IOV_MAX));
+            ssize_t written = writev(fd, iovs.data() + first, num_iovs);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::string error = std::strerror(errno);
+                close(fd);
+                throw std::runtime_error("Could not write to file: " + file_path + " (" + error + ")");
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iovs.size() && remaining >= iovs[first].iov_len) {
+                remaining -= iovs[first].iov_len;
+                ++first;
+            }
+            if (remaining > 0) {
+                iovs[first].iov_base = static_cast<char*>(iovs[first].iov_base) + remaining;
+                iovs[first].iov_len -= remaining;
+            }
+        }
+
+        if (!replaced_path.empty()) {
+            struct stat replaced_stat;
+            bool is_failed = (stat(replaced_path.c_str(), &replaced_stat) == 0 &&
+                              fchmod(fd, replaced_stat.st_mode & 07777) == -1) ||
+                             fsync(fd) == -1;
+            if (is_failed) {
+                std::string error = std::strerror(errno);
+                close(fd);
+                throw std::runtime_error("Could not write to file: " + file_path + " (" + error + ")");
+            }
+        }
+
+        if (close(fd) == -1) {
+            throw std::runtime_error("Could not write to file: " + file_path);
+        }
+    #else
+        std::ofstream file(file_path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + file_path);
+        }
+        for (const auto& buffer : buffers) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Could not write to file: " + file_path);
+        }
+
+        std::error_code error;
+        if (!replaced_path.empty() && fs::exists(replaced_path, error)) {
+            fs::permissions(file_path, fs::status(replaced_path).permissions());
+        }
+    #endif
+}
+
+/**
+ * @brief Requests the kernel to read files into the page cache in the background.
+ *
+ * @param file_paths Paths of the files to prefetch (missing files are skipped).
+ */
+void prefetchFiles(const std::vector<std::string>& file_paths) {
+    #ifdef __linux__
+        for (const auto& file_path : file_paths) {
+            int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd != -1) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+                close(fd);
+            }
+        }
+    #else
+        (void)file_paths;
+    #endif
+}
+
+} // namespace
+
 fs::path getExePath() {
     // Different implementation for each OS
     #ifdef _WIN32
@@ -63,37 +248,37 @@ void openFile(const std::string& file_path) {
 }
 
 std::string execCmd(const char* cmd) {
-    #ifdef _WIN32
+    #ifdef __linux__
+        // Spawned directly and drained in large reads, stderr goes to the caller's stderr
+        ProcessOptions options;
+        options.stderr_mode = StreamMode::kInherit;
+        ProcessResult result = runProcess({"/bin/sh", "-c", cmd}, options);
+        if (result.exit_code != 0) {
+            throw std::runtime_error("Command execution failed or command not found!");
+        }
+        return std::move(result.stdout_data);
+    #elif _WIN32
         FILE* pipe = _popen(cmd, "r");
-    #elif __linux__
-        FILE* pipe = popen(cmd, "r");
-    #else
-        std::cerr << "Unsupported operating system!" << std::endl;
-        std::exit(-1);
-    #endif
-
-    if (!pipe) {
-        throw std::runtime_error("Opening process pipe failed!");
-    }
+        if (!pipe) {
+            throw std::runtime_error("Opening process pipe failed!");
+        }
 
-    std::string result;  // Initialize string variable to store the output
+        std::string result;  // Initialize string variable to store the output
 
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        result += buffer;
-    }
+        char buffer[4096];
+        size_t num_read;
+        while ((num_read = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+            result.append(buffer, num_read);
+        }
 
-    #ifdef _WIN32
-        int return_code = _pclose(pipe);
+        if (_pclose(pipe) != 0) {
+            throw std::runtime_error("Command execution failed or command not found!");
+        }
+        return result;
     #else
-        int return_code = pclose(pipe);
+        std::cerr << "Unsupported operating system!" << std::endl;
+        std::exit(-1);
     #endif
-
-    if (return_code != 0) {
-        throw std::runtime_error("Command execution failed or command not found!");
-    }
-
-    return result;
 }
 
 fs::path getAbsPath(const std::filesystem::path& dir_path, 
@@ -115,48 +300,213 @@ std::string removeExtension(const std::string& filename) {
 }
 
 std::string getFileContent(const std::string& file_path) {
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file for reading: " + file_path);
+    std::string content;
+    appendFileContent(file_path, content);
+    return content;
+}
+
+void appendFileContent(const std::string& file_path, std::string& content) {
+    size_t original_size = content.size();
+    size_t offset = original_size;
+    #ifdef __linux__
+        int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error("Could not open file for reading: " + file_path);
+        }
+        struct stat file_stat;
+        size_t file_size = 0;
+        if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+            file_size = static_cast<size_t>(file_stat.st_size);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+
+        // Size once for the expected content plus one byte to detect the end of the file,
+        // then grow in large blocks for files without a size (pipes, procfs) or that grew
+        content.resize(offset + file_size + 1);
+        while (true) {
+            if (offset == content.size()) {
+                content.resize(offset + kReadBlockSize);
+            }
+            ssize_t num_read = read(fd, content.data() + offset, content.size() - offset);
+            if (num_read == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                close(fd);
+                content.resize(original_size);
+                throw std::runtime_error("Could not read file: " + file_path);
+            }
+            if (num_read == 0) {
+                break;
+            }
+            offset += static_cast<size_t>(num_read);
+        }
+        close(fd);
+    #else
+        std::ifstream file(file_path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for reading: " + file_path);
+        }
+
+        // Read the expected size plus one byte in one go, then in blocks if the file grew
+        std::error_code error;
+        uintmax_t file_size = fs::file_size(file_path, error);
+        size_t block_size = error ? kReadBlockSize : static_cast<size_t>(file_size) + 1;
+        while (true) {
+            content.resize(offset + block_size);
+            file.read(content.data() + offset, static_cast<std::streamsize>(block_size));
+            offset += static_cast<size_t>(file.gcount());
+            if (!file) {
+                break;
+            }
+            block_size = kReadBlockSize;
+        }
+        if (file.bad()) {
+            content.resize(original_size);
+            throw std::runtime_error("Could not read file: " + file_path);
+        }
+    #endif
+    content.resize(offset);
+}
+
+std::vector<std::future<std::string>> readFilesAsync(const std::vector<std::string>& file_paths) {
+    prefetchFiles(file_paths);
+
+    ThreadPool& pool = ThreadPool::getIo();
+    std::vector<std::future<std::string>> contents;
+    contents.reserve(file_paths.size());
+    for (const auto& file_path : file_paths) {
+        contents.push_back(pool.submit([file_path]() { return getFileContent(file_path); }));
     }
+    return contents;
+}
 
-    std::string content((std::istreambuf_iterator<char>(file)),
-        std::istreambuf_iterator<char>());
-    return content;
+void readFilesAsync(const std::vector<std::string>& file_paths,
+                    const std::function<void(FileReadResult&&)>& callback) {
+    prefetchFiles(file_paths);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::queue<FileReadResult> completed;
+    ThreadPool& pool = ThreadPool::getIo();
+    for (size_t index = 0; index < file_paths.size(); ++index) {
+        pool.submit([&, index]() {
+            FileReadResult result;
+            result.index = index;
+            try {
+                result.content = getFileContent(file_paths[index]);
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+            // Notify under the lock, as the caller may return right after the last pop
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push(std::move(result));
+            cv.notify_one();
+        });
+    }
+
+    // Deliver on this thread; all reads are awaited even if the callback throws,
+    // as the tasks refer to the local queue
+    std::exception_ptr callback_error;
+    for (size_t num_delivered = 0; num_delivered < file_paths.size(); ++num_delivered) {
+        FileReadResult result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&completed]() { return !completed.empty(); });
+            result = std::move(completed.front());
+            completed.pop();
+        }
+        if (!callback_error) {
+            try {
+                callback(std::move(result));
+            } catch (...) {
+                callback_error = std::current_exception();
+            }
+        }
+    }
+    if (callback_error) {
+        std::rethrow_exception(callback_error);
+    }
 }
 
 std::string getMergedContent(const std::vector<std::string>& file_paths) {
+    size_t total_size = file_paths.size();
+    for (const auto& file_path : file_paths) {
+        std::error_code error;
+        uintmax_t file_size = fs::file_size(file_path, error);
+        total_size += error ? 0 : static_cast<size_t>(file_size);
+    }
+
     std::string merged_content;
+    merged_content.reserve(total_size);  // Line breaks leave room for the end-of-file probes
     for (const auto& file_path : file_paths) {
-        merged_content += getFileContent(file_path) + "\n";
+        appendFileContent(file_path, merged_content);
+        merged_content += '\n';
     }
     return merged_content;
 }
 
-void writeStrToFile(const std::string& str, const std::string& file_path) {
-    std::ofstream file(file_path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file for writing: " + file_path);
+bool writeStrToFile(const std::string& str, const std::string& file_path, WriteMode mode) {
+    return writeBuffersToFile({str}, file_path, mode);
+}
+
+bool writeBuffersToFile(const std::vector<std::string_view>& buffers, const std::string& file_path,
+                        WriteMode mode) {
+    if (mode == WriteMode::kSkipUnchanged && hasFileContent(buffers, file_path)) {
+        return false;
     }
-    file << str;
-    file.close();
+    if (mode == WriteMode::kTruncate) {
+        writeBuffers(buffers, file_path);
+        return true;
+    }
+
+    // Replace the target of a symbolic link rather than the link itself
+    std::error_code error;
+    std::string target_path = file_path;
+    if (fs::is_symlink(file_path, error)) {
+        fs::path canonical_path = fs::canonical(file_path, error);
+        if (!error) {
+            target_path = canonical_path.string();
+        }
+    }
+
+    // Write next to the target, so that the rename stays on the same file system
+    static std::atomic<uint64_t> temp_counter{0};
+    std::string temp_path = target_path + ".tmp" + std::to_string(getProcessId()) + "_" +
+                            std::to_string(temp_counter++);
+    try {
+        writeBuffers(buffers, temp_path, target_path);
+    } catch (...) {
+        fs::remove(temp_path, error);
+        throw;
+    }
+    fs::rename(temp_path, target_path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+        throw std::runtime_error("Could not replace file: " + file_path);
+    }
+    return true;
 }
 
 bool isValidFile(const std::string& file_path, const std::string& extension) {
-    if (!std::filesystem::exists(file_path)) {
+    // One status call answers both existence and type
+    std::error_code error;
+    fs::file_status status = fs::status(file_path, error);
+    if (!fs::exists(status)) {
         std::cerr << "File does not exist: \"" << file_path << "\"" << std::endl;
         return false;
     }
-    else {
-        if (std::filesystem::is_directory(file_path)) {
-            std::cerr << "The path is a directory: \"" << file_path << "\"" << std::endl;
-            return false;
-        }
-        if (file_path.substr(file_path.find_last_of(".") + 1) != extension) {
-            std::cerr << "File does not have the correct extension: \"" 
-                      << file_path << "\"" << std::endl;
-            return false;
-        }
+    if (fs::is_directory(status)) {
+        std::cerr << "The path is a directory: \"" << file_path << "\"" << std::endl;
+        return false;
+    }
+    size_t last_dot = file_path.find_last_of('.');
+    std::string_view file_extension(file_path);
+    file_extension.remove_prefix((last_dot == std::string::npos) ? 0 : last_dot + 1);
+    if (file_extension != extension) {
+        std::cerr << "File does not have the correct extension: \""
+                  << file_path << "\"" << std::endl;
+        return false;
     }
     return true;
 }
@@ -0,0 +1,87 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file utils/src/thread_pool.cpp
+ * @brief Implementation of the class ThreadPool.
+ */
+#include "icarus/utils/thread_pool.h"
+
+#include <algorithm>
+
+namespace icarus::utils {
+
+namespace {
+
+/// Pool of which the current thread is a worker (nullptr for other threads).
+thread_local const ThreadPool* current_pool = nullptr;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::getNumThreads() const {
+    return workers_.size();
+}
+
+bool ThreadPool::isWorkerThread() const {
+    return current_pool == this;
+}
+
+ThreadPool& ThreadPool::getShared() {
+    static ThreadPool shared_pool;
+    return shared_pool;
+}
+
+ThreadPool& ThreadPool::getIo() {
+    static ThreadPool io_pool(kNumIoThreads);
+    return io_pool;
+}
+
+void ThreadPool::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::run() {
+    current_pool = this;
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return is_stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // Stopping and no jobs left
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop();
+        }
+        job();
+    }
+}
+
+} // namespace icarus::utils
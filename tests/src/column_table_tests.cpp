@@ -0,0 +1,95 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file tests/src/column_table_tests.cpp
+ * @brief Definition of the test cases of the test suite ColumnTableTests.
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Module under Test
+#include "icarus/utils/column_table.h"
+
+#include "project_fixtures.h"
+
+using namespace icarus;
+
+namespace tests {
+
+/**
+ * @test Tests the type inference, widening and null masks of a table read from YAML.
+ */
+TEST(ColumnTableTests, FromDataNode) {
+    DataNode spec((kTestDataDir / "signal_table.yaml").string());
+    ColumnTable table = ColumnTable::fromDataNode(spec["SIGNALS"]);
+    using ColumnType = ColumnTable::ColumnType;
+
+    ASSERT_EQ(table.getNumRows(), 3);
+    ASSERT_EQ(table.getNumColumns(), 5);
+    ASSERT_EQ(table.getColumn(size_t{0}).getName(), "time");
+
+    const ColumnTable::Column& time = table.getColumn("time");
+    ASSERT_EQ(time.getType(), ColumnType::kInt);
+    ASSERT_EQ(time.getInts(), (std::vector<int64_t>{0, 1, 2}));
+    ASSERT_THROW(time.getFloats(), std::runtime_error);
+
+    // Ints widen to floats, missing keys are null
+    const ColumnTable::Column& speed = table.getColumn("speed");
+    ASSERT_EQ(speed.getType(), ColumnType::kFloat);
+    ASSERT_DOUBLE_EQ(speed.getFloats()[1], 13.0);
+    ASSERT_TRUE(speed.isNull(2));
+    ASSERT_EQ(speed.getNullCount(), 1);
+
+    ASSERT_EQ(table.getColumn("active").getBools(), (std::vector<uint8_t>{1, 0, 1}));
+
+    // Mixed types widen to strings
+    const ColumnTable::Column& label = table.getColumn("label");
+    ASSERT_EQ(label.getType(), ColumnType::kString);
+    ASSERT_EQ(label.getStrings()[2], "3");
+    ASSERT_TRUE(label.isNull(1));
+    ASSERT_EQ(table.getColumn("extra").getNullCount(), 2);
+
+    // Emitting and converting again yields the same columns
+    ColumnTable round_trip = ColumnTable::fromDataNode(table.toDataNode());
+    ASSERT_EQ(round_trip.getNumColumns(), 5);
+    ASSERT_EQ(round_trip.getColumn("speed").getType(), ColumnType::kFloat);
+    ASSERT_EQ(round_trip.getColumn("speed").getNullMask(), speed.getNullMask());
+    ASSERT_EQ(round_trip.getColumn("extra").getInts()[2], -4);
+
+    ASSERT_THROW(ColumnTable::fromDataNode(spec), std::runtime_error);
+
+    // Only a single sign is accepted, and NaN is unsigned
+    DataNode signs;
+    signs.parseFromStr("- {plus: +7, double_sign: +-5, inf: +-.inf, neg_inf: -.inf, nan: +.nan}");
+    ColumnTable signed_table = ColumnTable::fromDataNode(signs);
+    ASSERT_EQ(signed_table.getColumn("plus").getType(), ColumnType::kInt);
+    ASSERT_EQ(signed_table.getColumn("double_sign").getType(), ColumnType::kString);
+    ASSERT_EQ(signed_table.getColumn("inf").getType(), ColumnType::kString);
+    ASSERT_EQ(signed_table.getColumn("neg_inf").getType(), ColumnType::kFloat);
+    ASSERT_EQ(signed_table.getColumn("nan").getType(), ColumnType::kString);
+}
+
+/**
+ * @test Tests the construction of a table from typed columns.
+ */
+TEST(ColumnTableTests, AddColumns) {
+    ColumnTable table;
+    table.addColumn("id", std::vector<int64_t>{1, 2, 3});
+    table.addColumn("gain", std::vector<double>{0.5, 0.0, 2.0}, {0, 1, 0});
+    table.addColumn("enabled", std::vector<bool>{true, false, true});
+    table.addColumn("name", std::vector<std::string>{"a", "b", "c"});
+
+    ASSERT_EQ(table.getNumRows(), 3);
+    ASSERT_TRUE(table.hasColumn("gain"));
+    ASSERT_TRUE(table.getColumn("gain").isNull(1));
+    ASSERT_EQ(table.getColumn("enabled").getBools(), (std::vector<uint8_t>{1, 0, 1}));
+
+    ASSERT_THROW(table.addColumn("id", std::vector<int64_t>{4, 5, 6}), std::runtime_error);
+    ASSERT_THROW(table.addColumn("short", std::vector<int64_t>{1}), std::runtime_error);
+    ASSERT_THROW(table.getColumn("unknown"), std::runtime_error);
+}
+
+} // namespace tests
@@ -9,6 +9,9 @@
 
 // Module under Test
 #include "icarus/utils/data_node.h"
+#include "icarus/utils/data_node_fmt.h"
+#include "icarus/utils/data_node_registry.h"
+#include "icarus/utils/symbol_pool.h"
 
 #include "project_fixtures.h"
 
@@ -125,4 +128,187 @@ TEST_F(DataNodeTests, Iterate) {
     }
 }
 
+/**
+ * @test Checks the memory and size statistics of data nodes.
+ */
+TEST_F(DataNodeTests, GetStats) {
+    // Basic map: root and four key-value children
+    DataNode::Stats map_stats = basic_map_.getStats();
+    ASSERT_EQ(map_stats.num_nodes, 5);
+    ASSERT_EQ(map_stats.max_depth, 1);
+    ASSERT_EQ(map_stats.max_map_width, 4);
+    ASSERT_EQ(map_stats.max_seq_width, 0);
+    ASSERT_GE(map_stats.node_capacity, map_stats.num_nodes);
+    ASSERT_GE(map_stats.arena_reserved, map_stats.arena_used);
+
+    // Feature model: FEATURES -> single-key map -> feature map -> reqs sequence -> value
+    DataNode fm_spec(fm_yaml_path_);
+    DataNode::Stats fm_stats = fm_spec.getStats();
+    ASSERT_EQ(fm_stats.max_depth, 5);
+    ASSERT_EQ(fm_stats.max_seq_width, 6);
+    ASSERT_EQ(fm_stats.max_map_width, 3);
+
+    // Statistics of a subtree only count its own nodes
+    DataNode::Stats features_stats = fm_spec["FEATURES"].getStats();
+    ASSERT_EQ(features_stats.max_depth, 4);
+    ASSERT_EQ(features_stats.num_nodes, fm_stats.num_nodes - 2);
+}
+
+/**
+ * @test Checks the aggregation of statistics per source file in the registry.
+ */
+TEST_F(DataNodeTests, StatsRegistry) {
+    DataNodeRegistry& registry = DataNodeRegistry::getInstance();
+    registry.clear();
+    registry.setEnabled(true);
+
+    DataNode fm_spec(fm_yaml_path_);
+    DataNode fm_spec_2(fm_yaml_path_);
+    registry.setEnabled(false);
+
+    DataNodeRegistry::SourceStats source_stats = registry.getSourceStats(fm_yaml_path_);
+    ASSERT_EQ(source_stats.num_loads, 2);
+    ASSERT_EQ(source_stats.last.num_nodes, fm_spec.getStats().num_nodes);
+    ASSERT_EQ(registry.getTotal().num_nodes, source_stats.last.num_nodes);
+
+    DataNode report = registry.toDataNode();
+    ASSERT_TRUE(report.hasChild(fm_yaml_path_.c_str()));
+    ASSERT_EQ(report[fm_yaml_path_]["num_loads"].as<int>(), 2);
+
+    registry.clear();
+    ASSERT_EQ(registry.getSourceStats(fm_yaml_path_).num_loads, 0);
+}
+
+/**
+ * @test Checks the resolution of values tagged with !include when parsing files.
+ */
+TEST_F(DataNodeTests, ResolveIncludes) {
+    DataNode spec((kTestDataDir / "include_main.yaml").string());
+
+    // The same file is spliced into every node that references it
+    ASSERT_EQ(spec["NAME"].as<std::string>(), "composed");
+    ASSERT_TRUE(spec["PORTS"].isSeq());
+    ASSERT_EQ(spec["PORTS"].getNumChildren(), 2);
+    ASSERT_EQ(spec["PORTS_COPY"].getNumChildren(), 2);
+    ASSERT_EQ(spec["PORTS"][1]["result"]["direction"].as<std::string>(), "output");
+
+    // Nested includes are resolved relative to the including file
+    DataNode contract = spec["CONTRACTS"][0]["base"];
+    ASSERT_EQ(contract["assume"].as<std::string>(), "True");
+    ASSERT_EQ(contract["guarantee"].as<std::string>(), "result >= 0");
+
+    // Tags, anchors and aliases of included files are kept
+    std::string tagged = spec["TAGGED"].emitStr();
+    ASSERT_NE(tagged.find("&default_port"), std::string::npos);
+    ASSERT_NE(tagged.find("*default_port"), std::string::npos);
+    ASSERT_NE(tagged.find("!!str int_number"), std::string::npos);
+
+    // Cyclic includes are rejected
+    ASSERT_THROW(DataNode((kTestDataDir / "include_cycle_a.yaml").string()), std::runtime_error);
+}
+
+/**
+ * @test Checks that the parallel emission of large nodes equals the serial emission.
+ */
+TEST_F(DataNodeTests, ParallelEmit) {
+    DataNode large_map(DataNode::Type::kMap);
+    DataNode large_seq(DataNode::Type::kSeq);
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "port_" + std::to_string(i);
+        large_map[key]["direction"] << ((i % 2 == 0) ? "input" : "output");
+        large_map[key]["width"] << i;
+        large_seq[i] << key;
+    }
+
+    for (DataNode::Format format : {DataNode::Format::kYaml, DataNode::Format::kJson}) {
+        ASSERT_EQ(large_map.emitStr(format, 4), large_map.emitStr(format));
+        ASSERT_EQ(large_seq.emitStr(format, 4), large_seq.emitStr(format));
+        ASSERT_EQ(large_seq.emitStr(format, 0), large_seq.emitStr(format));
+    }
+
+    // Small nodes are emitted serially
+    ASSERT_EQ(basic_map_.emitStr(DataNode::Format::kYaml, 4), basic_map_.emitStr());
+
+    // The written file reads back to the same data
+    std::string output_file_path = (results_dir_ / "parallel_emit.yaml").string();
+    large_map.writeToFile(output_file_path, DataNode::Format::kYaml, 4);
+    DataNode read_yaml(output_file_path);
+    ASSERT_EQ(read_yaml.getNumChildren(), 1000);
+    ASSERT_EQ(read_yaml["port_999"]["width"].as<int>(), 999);
+
+    // Regenerating the same content does not rewrite the file
+    ASSERT_FALSE(large_map.writeToFile(output_file_path, DataNode::Format::kYaml, 4,
+                                       utils::WriteMode::kSkipUnchanged));
+    large_map["port_0"]["width"] << 1;
+    ASSERT_TRUE(large_map.writeToFile(output_file_path, DataNode::Format::kYaml, 4,
+                                      utils::WriteMode::kSkipUnchanged));
+}
+
+/**
+ * @test Checks the formatting of data nodes with fmt in the supported styles.
+ */
+TEST_F(DataNodeTests, FormatFmt) {
+    ASSERT_EQ(fmt::format("{}", basic_seq_),
+              "- First element\n- Second element\n- Third element\n- Fourth element");
+    ASSERT_EQ(fmt::format("{:c}", basic_map_),
+              "{name: Steinbuch, nationality: German, age: 40, height: 1.78}");
+    ASSERT_EQ(fmt::format("{:jc}", basic_map_),
+              "{\"name\": \"Steinbuch\", \"nationality\": \"German\", \"age\": 40, \"height\": 1.78}");
+    ASSERT_EQ(fmt::format("{:j}", basic_seq_[0]), "\"First element\"");
+
+    // Depth-limited output elides nested containers
+    DataNode fm_spec(fm_yaml_path_);
+    std::string shallow = fmt::format("{:yc1}", fm_spec);
+    ASSERT_NE(shallow.find("FEATURES: [...]"), std::string::npos);
+    ASSERT_EQ(fmt::format("{:0}", fm_spec), "{...}");
+
+    // The emitted YAML reads back to the same data
+    DataNode read_back;
+    read_back.parseFromStr(fmt::format("{}", fm_spec));
+    ASSERT_EQ(read_back["FEATURES"].getNumChildren(), fm_spec["FEATURES"].getNumChildren());
+}
+
+/**
+ * @test Checks that the fmt formatter agrees with the Ryml emitter on the test data files.
+ */
+TEST_F(DataNodeTests, FormatFmtMatchesEmitter) {
+    auto trimNewlines = [](std::string str) {
+        str.erase(str.find_last_not_of('\n') + 1);
+        return str;
+    };
+
+    for (const char* file_name : {"abs_value.yaml", "contract_schema.yaml", "feature_model_schema.yaml",
+                                  "signal_table.yaml", "simple_calc_fm.yaml"}) {
+        SCOPED_TRACE(file_name);
+        DataNode node((kTestDataDir / file_name).string());
+        ASSERT_EQ(fmt::format("{}", node), trimNewlines(node.emitStr()));
+        ASSERT_EQ(fmt::format("{:j}", node), trimNewlines(node.emitStr(DataNode::Format::kJson)));
+
+        // The compact output reads back to the same data
+        DataNode read_back;
+        read_back.parseFromStr(fmt::format("{:c}", node));
+        ASSERT_EQ(read_back.emitStr(), node.emitStr());
+    }
+
+    // Plain YAML nulls are JSON nulls, quoted ones stay strings
+    DataNode nulls;
+    nulls.parseFromStr("{a: ~, b: '~', c: null}");
+    ASSERT_EQ(fmt::format("{:jc}", nulls), "{\"a\": null, \"b\": \"~\", \"c\": null}");
+}
+
+/**
+ * @test Checks that sequence elements and keys are interned as shared symbols.
+ */
+TEST_F(DataNodeTests, GetSeqSymbols) {
+    std::vector<utils::Symbol> symbols = basic_seq_.getSeqSymbols();
+    std::vector<std::string> strings = basic_seq_.getSeqStrings();
+    ASSERT_EQ(symbols.size(), strings.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        ASSERT_EQ(symbols[i].getView(), strings[i]);
+        ASSERT_EQ(symbols[i], utils::Symbol(strings[i]));
+    }
+    ASSERT_EQ(basic_map_["name"].getKeySymbol(), utils::Symbol("name"));
+    ASSERT_THROW(basic_map_.getSeqSymbols(), std::runtime_error);
+}
+
 } // namespace tests
@@ -0,0 +1,102 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file tests/src/expression_tests.cpp
+ * @brief Definition of the test cases of the test suite ExpressionTests.
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Module under Test
+#include "icarus/utils/expression.h"
+
+#include "project_fixtures.h"
+
+using namespace icarus;
+
+namespace tests {
+
+/**
+ * @test Tests the evaluation of expressions for single samples.
+ */
+TEST(ExpressionTests, Evaluate) {
+    std::vector<std::string> slots = {"input", "result", "port.field"};
+
+    Expression guarantee("result >= 0", slots);
+    ASSERT_TRUE(guarantee.isSatisfied({-3.0, 3.0, 0.0}));
+    ASSERT_FALSE(guarantee.isSatisfied({3.0, -3.0, 0.0}));
+    ASSERT_EQ(guarantee.getUsedSlots(), std::vector<size_t>{1});
+
+    // Operator precedence and functions
+    ASSERT_DOUBLE_EQ(Expression("1 + 2 * 3 - -4", slots).evaluate({0, 0, 0}), 11.0);
+    ASSERT_DOUBLE_EQ(Expression("(1 + 2) * 3 % 4", slots).evaluate({0, 0, 0}), 1.0);
+    ASSERT_DOUBLE_EQ(Expression("max(abs(input), port.field)", slots).evaluate({-5, 0, 2}), 5.0);
+
+    // Logic operators and boolean literals
+    Expression logic("not (input < 0) and result == abs(input) or False", slots);
+    ASSERT_TRUE(logic.isSatisfied({2.0, 2.0, 0.0}));
+    ASSERT_FALSE(logic.isSatisfied({-2.0, 2.0, 0.0}));
+    ASSERT_TRUE(Expression("True", slots).isSatisfied({0, 0, 0}));
+}
+
+/**
+ * @test Tests the compilation of expressions stored in a contract file.
+ */
+TEST(ExpressionTests, CompileFromDataNode) {
+    DataNode contract_spec((kTestDataDir / "abs_value.yaml").string());
+    DataNode contract = contract_spec["CONTRACTS"][0]["base"];
+    std::vector<std::string> slots = {"input", "result"};
+
+    Expression assume(contract["assume"], slots);
+    Expression guarantee(contract["guarantee"], slots);
+    ASSERT_EQ(guarantee.getSource(), "result >= 0");
+    ASSERT_TRUE(assume.isSatisfied({-1.0, 1.0}));
+    ASSERT_TRUE(guarantee.isSatisfied({-1.0, 1.0}));
+}
+
+/**
+ * @test Tests the batch evaluation over many samples.
+ */
+TEST(ExpressionTests, EvaluateBatch) {
+    std::vector<std::string> slots = {"input", "result"};
+    Expression guarantee("result == abs(input) and result >= 0", slots);
+
+    // More samples than one block to cover the block boundaries
+    const size_t num_samples = 1000;
+    std::vector<std::vector<double>> columns(2, std::vector<double>(num_samples));
+    for (size_t i = 0; i < num_samples; ++i) {
+        columns[0][i] = static_cast<double>(i) - 500.0;
+        columns[1][i] = (i % 7 == 0) ? -1.0 : std::abs(columns[0][i]);
+    }
+
+    std::vector<double> results = guarantee.evaluateBatch(columns);
+    ASSERT_EQ(results.size(), num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+        ASSERT_EQ(results[i], guarantee.evaluate({columns[0][i], columns[1][i]}));
+        ASSERT_EQ(results[i] != 0.0, i % 7 != 0);
+    }
+}
+
+/**
+ * @test Tests that invalid expressions are rejected when compiling.
+ */
+TEST(ExpressionTests, InvalidExpressions) {
+    std::vector<std::string> slots = {"input", "result"};
+    ASSERT_THROW(Expression("output >= 0", slots), std::runtime_error);
+    ASSERT_THROW(Expression("result >=", slots), std::runtime_error);
+    ASSERT_THROW(Expression("(result + 1", slots), std::runtime_error);
+    ASSERT_THROW(Expression("sqrt(result)", slots), std::runtime_error);
+    ASSERT_THROW(Expression("result # 1", slots), std::runtime_error);
+
+    // Deep nesting is rejected instead of overflowing the stack of the parser
+    ASSERT_THROW(Expression(std::string(100000, '-') + "result", slots), std::runtime_error);
+    ASSERT_THROW(Expression(std::string(100000, '!') + "result", slots), std::runtime_error);
+    ASSERT_THROW(Expression(std::string(100000, '(') + "result" + std::string(100000, ')'), slots),
+                 std::runtime_error);
+    ASSERT_NO_THROW(Expression(std::string(50, '(') + "result" + std::string(50, ')'), slots));
+}
+
+} // namespace tests
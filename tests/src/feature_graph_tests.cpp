@@ -0,0 +1,111 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file tests/src/feature_graph_tests.cpp
+ * @brief Definition of the test cases of the test suite FeatureGraphTests.
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Module under Test
+#include "icarus/utils/feature_graph.h"
+
+#include "project_fixtures.h"
+
+using namespace icarus;
+
+namespace tests {
+
+/**
+ * @test Tests the structure queries of the feature graph built from a feature model.
+ */
+TEST(FeatureGraphTests, BuildFromFeatureModel) {
+    DataNode fm_spec((kTestDataDir / "simple_calc_fm.yaml").string());
+    FeatureGraph graph(fm_spec);
+    using FeatureType = FeatureGraph::FeatureType;
+
+    ASSERT_EQ(graph.getNumFeatures(), 7);
+    ASSERT_EQ(graph.getName(graph.getRootId()), "SimpleCalculation");
+    ASSERT_EQ(graph.findFeature("Unknown"), FeatureGraph::kInvalidId);
+
+    FeatureGraph::FeatureId operands = graph.findFeature("Operands");
+    FeatureGraph::FeatureId two_inputs = graph.findFeature("TwoInputs");
+    FeatureGraph::FeatureId comparison = graph.findFeature("ThresholdComparison");
+    FeatureGraph::FeatureId compare_max = graph.findFeature("CompareMax");
+
+    // Children, parents and depths
+    ASSERT_EQ(graph.getChildren(graph.getRootId()).size(), 2);
+    ASSERT_EQ(graph.getChildren(operands).size(), 2);
+    ASSERT_EQ(graph.getParent(two_inputs), operands);
+    ASSERT_EQ(graph.getParent(graph.getRootId()), FeatureGraph::kInvalidId);
+    ASSERT_EQ(graph.getDepth(compare_max), 2);
+
+    // Ancestor queries
+    ASSERT_TRUE(graph.isAncestor(graph.getRootId(), compare_max));
+    ASSERT_TRUE(graph.isAncestor(comparison, compare_max));
+    ASSERT_FALSE(graph.isAncestor(operands, compare_max));
+    ASSERT_FALSE(graph.isAncestor(compare_max, compare_max));
+
+    // Types and groups
+    ASSERT_TRUE(graph.isOfType(compare_max, FeatureType::kXor));
+    ASSERT_EQ(graph.getType(graph.findFeature("ThreeInputs")), FeatureType::kOptional);
+    ASSERT_EQ(graph.getGroup(comparison, FeatureType::kXor).size(), 2);
+}
+
+/**
+ * @test Tests the validation of configurations.
+ */
+TEST(FeatureGraphTests, ValidateConfiguration) {
+    DataNode fm_spec((kTestDataDir / "simple_calc_fm.yaml").string());
+    FeatureGraph graph(fm_spec);
+
+    auto config = graph.makeFeatureSet({"SimpleCalculation", "Operands", "TwoInputs",
+                                        "ThresholdComparison", "CompareMax"});
+    ASSERT_EQ(config.count(), 5);
+    ASSERT_TRUE(graph.isValidConfiguration(config));
+
+    // Two members of the XOR group
+    config.insert(graph.findFeature("CompareMin"));
+    ASSERT_EQ(graph.validateConfiguration(config).size(), 1);
+
+    // No member of the XOR group and a missing mandatory feature
+    config.erase(graph.findFeature("CompareMin"));
+    config.erase(graph.findFeature("CompareMax"));
+    config.erase(graph.findFeature("TwoInputs"));
+    ASSERT_EQ(graph.validateConfiguration(config).size(), 2);
+
+    ASSERT_THROW(graph.makeFeatureSet({"Unknown"}), std::runtime_error);
+
+    // Sets of another size and out-of-range IDs are rejected
+    ASSERT_THROW(graph.validateConfiguration(FeatureGraph::FeatureSet()), std::runtime_error);
+    ASSERT_THROW(graph.isValidConfiguration(FeatureGraph::FeatureSet(graph.getNumFeatures() + 1)),
+                 std::runtime_error);
+    ASSERT_THROW(config.insert(static_cast<FeatureGraph::FeatureId>(graph.getNumFeatures())),
+                 std::runtime_error);
+    ASSERT_THROW(config.erase(FeatureGraph::kInvalidId), std::runtime_error);
+}
+
+/**
+ * @test Tests that malformed feature models are rejected.
+ */
+TEST(FeatureGraphTests, MalformedFeatureModels) {
+    DataNode unknown_parent;
+    unknown_parent.parseFromStr(
+        "ROOT: Root\n"
+        "FEATURES:\n"
+        "  - A: { type: optional, parent: Missing }\n");
+    ASSERT_THROW(FeatureGraph{unknown_parent}, std::runtime_error);
+
+    DataNode cycle;
+    cycle.parseFromStr(
+        "ROOT: Root\n"
+        "FEATURES:\n"
+        "  - A: { type: optional, parent: B }\n"
+        "  - B: { type: optional, parent: A }\n");
+    ASSERT_THROW(FeatureGraph{cycle}, std::runtime_error);
+}
+
+} // namespace tests
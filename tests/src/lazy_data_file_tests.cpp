@@ -0,0 +1,75 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file tests/src/lazy_data_file_tests.cpp
+ * @brief Definition of the test cases of the test suite LazyDataFileTests.
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Module under Test
+#include "icarus/utils/lazy_data_file.h"
+
+#include "project_fixtures.h"
+
+using namespace icarus;
+
+namespace tests {
+
+/**
+ * @test Tests the prescan of documents and top-level keys without parsing.
+ */
+TEST(LazyDataFileTests, IndexSections) {
+    LazyDataFile file((kTestDataDir / "lazy_sections.yaml").string());
+
+    ASSERT_EQ(file.getNumDocuments(), 5);
+    std::vector<std::string> expected_keys = {"NAME", "PORTS", "LIMITS", "DESCRIPTION"};
+    ASSERT_EQ(file.getKeys(0), expected_keys);
+    ASSERT_EQ(file.getKeys(1), std::vector<std::string>{"CONTRACTS"});
+
+    // Documents with aliases, without a root map or with directives are not split into sections
+    ASSERT_TRUE(file.getKeys(2).empty());
+    ASSERT_TRUE(file.getKeys(3).empty());
+    ASSERT_TRUE(file.getKeys(4).empty());
+    ASSERT_TRUE(file.hasKey("LIMITS"));
+    ASSERT_FALSE(file.hasKey("CONTRACTS"));
+    ASSERT_EQ(file.getNumParsed(), 0);
+    ASSERT_THROW(file.getKeys(5), std::runtime_error);
+}
+
+/**
+ * @test Tests that sections and documents are parsed only on first access.
+ */
+TEST(LazyDataFileTests, ParseOnAccess) {
+    LazyDataFile file((kTestDataDir / "lazy_sections.yaml").string());
+
+    DataNode ports = file.get("PORTS");
+    ASSERT_EQ(file.getNumParsed(), 1);
+    ASSERT_TRUE(ports.isSeq());
+    ASSERT_EQ(ports.getNumChildren(), 2);
+    ASSERT_EQ(ports[1]["output"]["direction"].as<std::string>(), "output");
+
+    // Cached sections are not parsed again
+    file.get("PORTS");
+    ASSERT_EQ(file.getNumParsed(), 1);
+    ASSERT_EQ(file.get("LIMITS")["max"].as<int>(), 10);
+    ASSERT_EQ(file.get("DESCRIPTION").as<std::string>(), "Multi-line text\nwith: colons\n");
+    ASSERT_EQ(file.get("CONTRACTS", 1)[0]["guarantee"].as<std::string>(), "x >= 0");
+    ASSERT_EQ(file.getNumParsed(), 4);
+
+    // Documents with aliases are parsed as a whole
+    ASSERT_EQ(file.get("port", 2)["width"].as<int>(), 8);
+    ASSERT_EQ(file.getDocument(3).getNumChildren(), 2);
+
+    // Documents with directives are parsed together with them
+    ASSERT_EQ(file.get("TAGGED", 4)["width"].as<int>(), 16);
+    ASSERT_EQ(file.get("OTHER", 4).as<int>(), 1);
+
+    ASSERT_THROW(file.get("UNKNOWN"), std::runtime_error);
+    ASSERT_THROW(file.getDocument(5), std::runtime_error);
+}
+
+} // namespace tests
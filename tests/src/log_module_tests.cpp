@@ -6,11 +6,22 @@
  * @brief Implementation of the fixture LogModuleTests and definition of its test cases.
  */
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 
 #include <gtest/gtest.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/null_sink.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/sinks/stdout_sinks.h>
+
+#include "project_fixtures.h"
 
 // Module under test
+#include "icarus/utils/binary_log.h"
 #include "icarus/utils/logging_module.h"
 
 
@@ -48,6 +59,19 @@ TEST_F(LogModuleTests, ConstructorWithLoggerName) {
     EXPECT_EQ(logging_module.getLoggerName(), logger_name);
 }
 
+/**
+ * @test Tests that uncolored loggers write to stdout in both log modes.
+ */
+TEST_F(LogModuleTests, ConstructorWithoutColors) {
+    for (LogMode mode : {LogMode::kSync, LogMode::kAsync}) {
+        LoggingModule logging_module(logger_name, false, mode);
+        ASSERT_EQ(logging_module.getLogger()->sinks().size(), 1u);
+        EXPECT_NE(std::dynamic_pointer_cast<spdlog::sinks::stdout_sink_mt>(
+                      logging_module.getLogger()->sinks()[0]), nullptr);
+        EXPECT_EQ(spdlog::get(logger_name), logging_module.getLogger());
+    }
+}
+
 // Test the constructor that takes an existing logger
 TEST_F(LogModuleTests, ConstructorWithExistingLogger) {
     LoggingModule logging_module(mock_logger);
@@ -83,4 +107,162 @@ TEST_F(LogModuleTests, LoggerDroppedOnDestruction) {
     EXPECT_EQ(spdlog::get(logger_name), nullptr);
 }
 
+/**
+ * @test Tests the creation of asynchronous loggers, explicitly and by the default log mode.
+ */
+TEST_F(LogModuleTests, AsyncLogMode) {
+    {
+        LoggingModule logging_module(logger_name, true, LogMode::kAsync);
+        EXPECT_NE(std::dynamic_pointer_cast<spdlog::async_logger>(logging_module.getLogger()), nullptr);
+        EXPECT_EQ(spdlog::get(logger_name), logging_module.getLogger());
+    }
+
+    LoggingModule::setDefaultLogMode(LogMode::kAsync);
+    {
+        LoggingModule logging_module(logger_name, false);
+        EXPECT_NE(std::dynamic_pointer_cast<spdlog::async_logger>(logging_module.getLogger()), nullptr);
+    }
+    LoggingModule::setDefaultLogMode(LogMode::kSync);
+    LoggingModule logging_module(logger_name);
+    EXPECT_EQ(std::dynamic_pointer_cast<spdlog::async_logger>(logging_module.getLogger()), nullptr);
+}
+
+/**
+ * @test Tests the configuration of the thread pool of the asynchronous loggers.
+ */
+TEST_F(LogModuleTests, AsyncLogConfig) {
+    EXPECT_THROW(LoggingModule::setAsyncConfig({0, 1, OverflowPolicy::kBlock}), std::runtime_error);
+    EXPECT_THROW(LoggingModule::setAsyncConfig({1024, 0, OverflowPolicy::kBlock}), std::runtime_error);
+
+    LoggingModule::setAsyncConfig({1024, 1, OverflowPolicy::kDropOldest});
+    EXPECT_EQ(LoggingModule::getAsyncConfig().queue_size, 1024u);
+    EXPECT_EQ(LoggingModule::getAsyncConfig().overflow_policy, OverflowPolicy::kDropOldest);
+    EXPECT_EQ(LoggingModule::getNumDroppedMessages(), 0u);
+    {
+        LoggingModule logging_module(logger_name, false, LogMode::kAsync);
+        logging_module.getLogger()->set_level(spdlog::level::off);
+        logging_module.getLogger()->info("Not written");
+        logging_module.getLogger()->flush();
+
+        // The replaced pool is kept while a logger uses it
+        LoggingModule::setAsyncConfig(AsyncLogConfig());
+        EXPECT_EQ(LoggingModule::getAsyncConfig().queue_size, AsyncLogConfig().queue_size);
+        bool has_error = false;
+        logging_module.getLogger()->set_error_handler([&has_error](const std::string&) { has_error = true; });
+        logging_module.getLogger()->flush();
+        EXPECT_FALSE(has_error);
+    }
+    EXPECT_EQ(LoggingModule::getNumDroppedMessages(), 0u);
+
+    LoggingModule::setAsyncConfig(AsyncLogConfig());
+}
+
+/**
+ * @test Tests that the logging macros only evaluate their arguments for enabled levels.
+ */
+TEST_F(LogModuleTests, LogMacros) {
+    LoggingModule logging_module(mock_logger);
+    mock_logger->set_level(spdlog::level::info);
+    int num_evaluations = 0;
+    auto getValue = [&num_evaluations]() { return ++num_evaluations; };
+
+    ICARUS_LOG_TRACE(logging_module, "Value: {}", getValue());
+    ICARUS_LOG_DEBUG(logging_module, "Value: {}", getValue());
+    EXPECT_EQ(num_evaluations, 0);
+
+    ICARUS_LOG_INFO(logging_module, "Value: {}", getValue());
+    ICARUS_LOG_ERROR(logging_module, "Value: {}", getValue());
+    EXPECT_EQ(num_evaluations, 2);
+
+    // Modules without a logger are skipped
+    logging_module.setLogger(nullptr);
+    ICARUS_LOG_CRITICAL(logging_module, "Value: {}", getValue());
+    EXPECT_EQ(num_evaluations, 2);
+}
+
+/**
+ * @test Tests the binary logging macros with formatting by the background thread.
+ */
+TEST_F(LogModuleTests, BinaryLogger) {
+    std::ostringstream output;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output);
+    sink->set_pattern("%l %v");
+    auto text_logger = std::make_shared<spdlog::logger>("binary_text", sink);
+
+    LoggingModule logging_module(mock_logger);
+    logging_module.setBinaryLogger(std::make_shared<BinaryLogger>(text_logger));
+    EXPECT_EQ(logging_module.getBinaryLogger()->getLevel(), spdlog::level::info);
+
+    int num_evaluations = 0;
+    auto getValue = [&num_evaluations]() { return ++num_evaluations; };
+    ICARUS_BLOG_DEBUG(logging_module, "Value: {}", getValue());
+    EXPECT_EQ(num_evaluations, 0);
+
+    std::string name = "step";
+    ICARUS_BLOG_INFO(logging_module, "No arguments");
+    ICARUS_BLOG_WARN(logging_module, "{} {} took {:.2f} s ({}, {}, {}, {})", name, 42u, 1.5,
+                     true, 'x', std::string_view("view"), -7);
+    std::thread thread([&logging_module]() {
+        ICARUS_BLOG_ERROR(logging_module, "From {}", "thread");
+    });
+    thread.join();
+    logging_module.getBinaryLogger()->flush();
+
+    std::string text = output.str();
+    EXPECT_NE(text.find("info No arguments\n"), std::string::npos);
+    EXPECT_NE(text.find("warning step 42 took 1.50 s (true, x, view, -7)\n"), std::string::npos);
+    EXPECT_NE(text.find("error From thread\n"), std::string::npos);
+    EXPECT_EQ(logging_module.getBinaryLogger()->getNumDroppedRecords(), 0u);
+
+    // The ring buffer of the exited thread was removed after draining it
+    EXPECT_EQ(logging_module.getBinaryLogger()->getNumRingBuffers(), 1u);
+}
+
+/**
+ * @test Tests writing a binary log file and decoding it offline.
+ */
+TEST_F(LogModuleTests, BinaryLogFile) {
+    std::string file_path = (tests::kTestResutDir / "binary_log.bin").string();
+    {
+        LoggingModule logging_module(mock_logger);
+        logging_module.setBinaryLogger(std::make_shared<BinaryLogger>(file_path));
+        for (int i = 0; i < 1000; ++i) {
+            ICARUS_BLOG_INFO(logging_module, "Record {} of {}", i, "file");
+        }
+    }
+
+    std::ostringstream output;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output);
+    sink->set_pattern("%v");
+    auto text_logger = std::make_shared<spdlog::logger>("binary_decoder", sink);
+    EXPECT_EQ(BinaryLogger::decodeFile(file_path, text_logger), 1000u);
+    EXPECT_EQ(output.str().find("Record 0 of file\nRecord 1 of file\n"), 0u);
+    EXPECT_NE(output.str().find("Record 999 of file\n"), std::string::npos);
+
+    EXPECT_THROW(BinaryLogger::decodeFile((tests::kTestDataDir / "abs_value.yaml").string(), text_logger),
+                 std::runtime_error);
+}
+
+/**
+ * @test Tests that records are dropped and counted if a ring buffer is full.
+ */
+TEST_F(LogModuleTests, BinaryLoggerOverflow) {
+    BinaryLogConfig config;
+    config.ring_size = 4096;
+    config.poll_interval = std::chrono::hours(1);  // Drain only on flush
+    LoggingModule logging_module(mock_logger);
+    logging_module.setBinaryLogger(std::make_shared<BinaryLogger>(mock_logger, config));
+    for (int i = 0; i < 1000; ++i) {
+        ICARUS_BLOG_INFO(logging_module, "Record {}", i);
+    }
+    size_t num_dropped = logging_module.getBinaryLogger()->getNumDroppedRecords();
+    EXPECT_GT(num_dropped, 0u);
+    EXPECT_LT(num_dropped, 1000u);
+
+    // Space is available again after draining
+    logging_module.getBinaryLogger()->flush();
+    ICARUS_BLOG_INFO(logging_module, "Record {}", 1000);
+    EXPECT_EQ(logging_module.getBinaryLogger()->getNumDroppedRecords(), num_dropped);
+}
+
 } // namespace icarus
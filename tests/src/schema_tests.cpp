@@ -0,0 +1,103 @@
+/**
+ * (c) 2024 Houssem Guissouma.
+ * Licensed under the BSD-3-Clause License.
+ *
+ * @file tests/src/schema_tests.cpp
+ * @brief Definition of the test cases of the test suite SchemaTests.
+ */
+#include <string>
+
+#include <gtest/gtest.h>
+
+// Module under Test
+#include "icarus/utils/schema.h"
+
+#include "project_fixtures.h"
+
+using namespace icarus;
+
+namespace tests {
+
+/**
+ * @test Tests the validation of valid contract and feature model files.
+ */
+TEST(SchemaTests, ValidateValidFiles) {
+    Schema contract_schema((kTestDataDir / "contract_schema.yaml").string());
+    DataNode contract_spec((kTestDataDir / "abs_value.yaml").string());
+    ASSERT_TRUE(contract_schema.validate(contract_spec).empty());
+
+    Schema fm_schema((kTestDataDir / "feature_model_schema.yaml").string());
+    DataNode fm_spec((kTestDataDir / "simple_calc_fm.yaml").string());
+    ASSERT_TRUE(fm_schema.isValid(fm_spec));
+
+    // The feature model is not a valid contract file
+    ASSERT_FALSE(contract_schema.isValid(fm_spec));
+}
+
+/**
+ * @test Tests that all violations of an invalid document are reported with their paths.
+ */
+TEST(SchemaTests, ReportViolations) {
+    Schema contract_schema((kTestDataDir / "contract_schema.yaml").string());
+
+    DataNode invalid_spec;
+    invalid_spec.parseFromStr(
+        "PORTS:\n"
+        "  - input:\n"
+        "      direction: inout\n"
+        "      interface: int_number\n"
+        "      unit: m\n"
+        "  - result:\n"
+        "      direction: output\n");
+
+    std::vector<Schema::Violation> violations = contract_schema.validate(invalid_spec);
+    ASSERT_EQ(violations.size(), 4);
+    ASSERT_EQ(violations[0].path, "$.PORTS[0].input.direction");
+    ASSERT_EQ(violations[1].path, "$.PORTS[0].input.unit");
+    ASSERT_EQ(violations[2].path, "$.PORTS[1].result");
+    ASSERT_EQ(violations[2].message, "Missing required key 'interface'.");
+    ASSERT_EQ(violations[3].path, "$");
+    ASSERT_EQ(violations[3].message, "Missing required key 'CONTRACTS'.");
+}
+
+/**
+ * @test Tests the scalar types and size bounds of schema rules.
+ */
+TEST(SchemaTests, ScalarTypesAndBounds) {
+    DataNode schema_spec;
+    schema_spec.parseFromStr(
+        "type: map\n"
+        "properties:\n"
+        "  count: { type: int }\n"
+        "  ratio: { type: float }\n"
+        "  flag: { type: bool }\n"
+        "  names: { type: seq, max_size: 2, items: { type: str } }\n");
+    Schema schema(schema_spec);
+
+    DataNode valid_doc;
+    valid_doc.parseFromStr("count: -3\nratio: 1.5e3\nflag: True\nnames: [a, b]\n");
+    ASSERT_TRUE(schema.isValid(valid_doc));
+
+    DataNode invalid_doc;
+    invalid_doc.parseFromStr("count: 1.5\nratio: abc\nflag: 1\nnames: [a, b, c]\n");
+    ASSERT_EQ(schema.validate(invalid_doc).size(), 4);
+
+    // Infinity may be signed, NaN may not
+    for (const char* value : {"-.inf", "+.Inf", ".NaN"}) {
+        DataNode special_doc;
+        special_doc.parseFromStr(std::string("ratio: ") + value + "\n");
+        ASSERT_TRUE(schema.isValid(special_doc)) << value;
+    }
+    for (const char* value : {"+.nan", "-.nan"}) {
+        DataNode special_doc;
+        special_doc.parseFromStr(std::string("ratio: ") + value + "\n");
+        ASSERT_FALSE(schema.isValid(special_doc)) << value;
+    }
+
+    // Invalid schema specifications are rejected when compiling
+    DataNode invalid_schema;
+    invalid_schema.parseFromStr("type: number\n");
+    ASSERT_THROW(Schema{invalid_schema}, std::runtime_error);
+}
+
+} // namespace tests
@@ -7,8 +7,16 @@
  */
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#include <spdlog/sinks/ostream_sink.h>
+
 // Module under Test
+#include "icarus/utils/indented_writer.h"
 #include "icarus/utils/str_processing.h"
+#include "icarus/utils/symbol_pool.h"
 
 using namespace icarus::utils;
 
@@ -33,6 +41,10 @@ TEST(StrProcTests, TrimStr) {
 	// Test string with only whitespaces
 	test_str = "    ";
 	ASSERT_EQ(trimStr(test_str), "");
+
+	// All ASCII whitespaces are trimmed
+	ASSERT_EQ(trimStr("\t\r\n Tabs\tinside \n"), "Tabs\tinside");
+	ASSERT_EQ(trimStrView("  view  "), "view");
 }
 
 /**
@@ -91,6 +103,79 @@ TEST(StrProcTests, PrintIndentedString) {
 	ASSERT_EQ(output, "    Hello, World!\n    How are you?\n    I am fine.\n");
 }
 
+/**
+ * @test Tests the hanging indentation of the function printIndentedString.
+ */
+TEST(StrProcTests, PrintIndentedStringHanging) {
+	testing::internal::CaptureStdout();
+	printIndentedString("first\n\nthird\n", "- ");
+	std::string output = testing::internal::GetCapturedStdout();
+	ASSERT_EQ(output, "- first\n  \n  third\n");
+
+	testing::internal::CaptureStdout();
+	printIndentedString("", "- ");
+	output = testing::internal::GetCapturedStdout();
+	ASSERT_EQ(output, "");
+}
+
+/**
+ * @test Tests the nested indentation and buffering of the class IndentedWriter.
+ */
+TEST(StrProcTests, IndentedWriter) {
+	std::string output;
+	{
+		IndentedWriter writer = IndentedWriter::toString(output);
+		writer.writeLine("root:");
+		writer.pushIndent(2);
+		writer.write("a: 1\nb:\n");
+		writer.pushIndent("- ", true);
+		writer.write("x\ny\n");
+		writer.popIndent();
+		writer.pushIndent("- ", true);
+		writer.write("z");
+		writer.writeRaw(" (raw)\n");
+		writer.popIndent();
+		ASSERT_EQ(writer.getIndentLevel(), 1);
+		writer.popIndent();
+		ASSERT_THROW(writer.popIndent(), std::runtime_error);
+		writer.writeLine("end");
+		ASSERT_TRUE(output.empty());  // Nothing passed to the sink before flushing
+	}
+	ASSERT_EQ(output, "root:\n  a: 1\n  b:\n  - x\n    y\n  - z (raw)\nend\n");
+
+	// Buffer smaller than the text: flushed when full, large pieces bypass it
+	output.clear();
+	std::string long_line(100, 'a');
+	{
+		IndentedWriter writer([&output](std::string_view text) { output.append(text); }, 16);
+		writer.pushIndent(4);
+		writer.writeLine(long_line);
+		writer.writeLine("short");
+	}
+	ASSERT_EQ(output, "    " + long_line + "\n    short\n");
+
+	// Lines are never split when the buffer is full, so the logger gets one message per line
+	std::ostringstream log_stream;
+	auto sink = std::make_shared<spdlog::sinks::ostream_sink_st>(log_stream);
+	sink->set_pattern("%v");
+	auto logger = std::make_shared<spdlog::logger>("indented_writer_test", sink);
+	size_t num_lines = 2000;  // Exceeds the default buffer size
+	{
+		IndentedWriter writer = IndentedWriter::toLogger(logger);
+		writer.pushIndent(3);
+		for (size_t i = 0; i < num_lines; ++i) {
+			writer.writeLine("line " + std::to_string(i));
+		}
+		writer.writeLine(long_line);
+	}
+	std::string expected;
+	for (size_t i = 0; i < num_lines; ++i) {
+		expected += "   line " + std::to_string(i) + "\n";
+	}
+	expected += "   " + long_line + "\n";
+	ASSERT_EQ(log_stream.str(), expected);
+}
+
 /**
  * @test Tests the functions containsWhitespace and containsSpecialChars.
  */
@@ -111,4 +196,156 @@ TEST(StrProcTests, StrContainsChars) {
 	ASSERT_TRUE(containsSpecialChars(test_str));
 }
 
+/**
+ * @test Tests the vectorized character checks against a per-character reference for all
+ *       byte values, at positions covering full vectors and remainders.
+ */
+TEST(StrProcTests, StrContainsCharsAllBytes) {
+	auto isSpace = [](unsigned char c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+	auto isIdent = [](unsigned char c) {
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+			   c == '_' || c == '-';
+	};
+
+	for (size_t length : {1, 15, 16, 17, 31, 32, 33, 70}) {
+		for (size_t pos : {size_t{0}, length / 2, length - 1}) {
+			for (int byte = 0; byte < 256; ++byte) {
+				std::string str(length, 'a');
+				str[pos] = static_cast<char>(byte);
+				unsigned char c = static_cast<unsigned char>(byte);
+				ASSERT_EQ(containsWhitespace(str), isSpace(c)) << "byte " << byte << " at " << pos;
+				ASSERT_EQ(containsSpecialChars(str), !isIdent(c)) << "byte " << byte << " at " << pos;
+			}
+		}
+	}
+
+	// Batch checks
+	std::vector<std::string> names = {"valid_name", "with space", "special$", ""};
+	ASSERT_EQ(containsWhitespace(names), (std::vector<bool>{false, true, false, false}));
+	ASSERT_EQ(containsSpecialChars(names), (std::vector<bool>{false, true, true, false}));
+}
+
+/**
+ * @test Tests the hashed string set and the functions taking it.
+ */
+TEST(StrProcTests, StringSet) {
+	StringSet set;
+	ASSERT_FALSE(set.contains("port"));
+	ASSERT_TRUE(set.insert("port"));
+	ASSERT_FALSE(set.insert("port"));
+	ASSERT_TRUE(set.insert(""));
+
+	// Enough strings to rehash several times
+	for (int i = 0; i < 10000; ++i) {
+		set.insert("feature_" + std::to_string(i));
+	}
+	ASSERT_EQ(set.size(), 10002);
+	ASSERT_EQ(set.find("port"), 0);
+	ASSERT_EQ(set.find("feature_9999"), 10001);
+	ASSERT_EQ(set.find("feature_10000"), StringSet::npos);
+	ASSERT_EQ(set.getStrings()[2], "feature_0");
+	ASSERT_TRUE(isInVector(std::string_view("feature_42"), set));
+
+	// Bulk removal with a set and with a vector large enough to be hashed
+	std::vector<std::string> to_remove;
+	for (int i = 0; i < 100; i += 2) {
+		to_remove.push_back("p" + std::to_string(i));
+	}
+	std::vector<std::string> source;
+	for (int i = 0; i < 100; ++i) {
+		source.push_back("p" + std::to_string(i));
+	}
+	std::vector<std::string> source_copy = source;
+	removeStringsFromVector(source, StringSet(to_remove));
+	removeStringsFromVector(source_copy, to_remove);
+	ASSERT_EQ(source.size(), 50);
+	ASSERT_EQ(source[0], "p1");
+	ASSERT_EQ(source, source_copy);
+
+	set.clear();
+	ASSERT_TRUE(set.empty());
+	ASSERT_FALSE(set.contains("port"));
+}
+
+/**
+ * @test Tests splitting strings with SplitRange and splitString.
+ */
+TEST(StrProcTests, SplitRange) {
+	using Tokens = std::vector<std::string_view>;
+
+	ASSERT_EQ(SplitRange("a.b..c", '.').toVector(), (Tokens{"a", "b", "", "c"}));
+	ASSERT_EQ(SplitRange("a.b..c", '.').skipEmpty().toVector(), (Tokens{"a", "b", "c"}));
+	ASSERT_EQ(SplitRange("", ',').toVector(), (Tokens{""}));
+	ASSERT_TRUE(SplitRange("", ',').skipEmpty().toVector().empty());
+
+	// Multi-character delimiters, trimming and character sets
+	ASSERT_EQ(SplitRange("x -> y ->z", "->").trim().toVector(), (Tokens{"x", "y", "z"}));
+	ASSERT_EQ(SplitRange("abc", "").toVector(), (Tokens{"abc"}));
+	ASSERT_EQ(SplitRange::anyOf("a, b;c ,", ",;").trim().skipEmpty().toVector(),
+			  (Tokens{"a", "b", "c"}));
+
+	// The rest of the string is the last token after the maximum number of splits
+	ASSERT_EQ(SplitRange("port.field.sub", '.').maxSplits(1).toVector(),
+			  (Tokens{"port", "field.sub"}));
+	ASSERT_EQ(SplitRange("port.field", '.').maxSplits(0).toVector(), (Tokens{"port.field"}));
+
+	size_t num_tokens = 0;
+	for (std::string_view token : SplitRange(" in1 , in2 ", ',').trim()) {
+		ASSERT_EQ(token.substr(0, 2), "in");
+		++num_tokens;
+	}
+	ASSERT_EQ(num_tokens, 2);
+
+	// The part after a multi-character delimiter does not start with its remainder
+	ASSERT_EQ(splitString("port::field", "::"), std::make_pair(std::string("port"), std::string("field")));
+	ASSERT_EQ(splitString("port.field", "::"), std::make_pair(std::string(), std::string()));
+}
+
+/**
+ * @test Tests the interning of strings as symbols, also from concurrent threads.
+ */
+TEST(StrProcTests, SymbolPool) {
+	SymbolPool pool;
+	Symbol port = pool.intern("EngineSpeed");
+	ASSERT_EQ(port, pool.intern(std::string("Engine") + "Speed"));
+	ASSERT_NE(port, pool.intern("VehicleSpeed"));
+	ASSERT_EQ(port.getView(), "EngineSpeed");
+	ASSERT_STREQ(port.c_str(), "EngineSpeed");
+	ASSERT_EQ(pool.getSymbol(port.getId()), port);
+	ASSERT_THROW(pool.getSymbol(port.getId() + SymbolPool::kNumShards * 1000), std::runtime_error);
+	ASSERT_TRUE(pool.intern("").empty());
+	ASSERT_EQ(pool.intern(""), Symbol());
+	ASSERT_FALSE(pool.find("Unknown").has_value());
+	ASSERT_EQ(pool.find("VehicleSpeed")->getView(), "VehicleSpeed");
+	ASSERT_EQ(pool.size(), 2);
+
+	// Large strings and the global pool
+	std::string large(100000, 'x');
+	ASSERT_EQ(pool.intern(large).getView(), large);
+	ASSERT_EQ(Symbol("EngineSpeed"), Symbol(std::string_view("EngineSpeed")));
+	ASSERT_NE(Symbol("EngineSpeed"), port);  // Different pools
+
+	// Concurrent interning yields one symbol per string
+	constexpr size_t kNumThreads = 4;
+	constexpr size_t kNumNames = 2000;
+	std::vector<std::vector<Symbol>> results(kNumThreads);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < kNumThreads; ++t) {
+		threads.emplace_back([&pool, &results, t]() {
+			for (size_t i = 0; i < kNumNames; ++i) {
+				results[t].push_back(pool.intern("signal_" + std::to_string(i)));
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	std::unordered_set<Symbol> unique_symbols(results[0].begin(), results[0].end());
+	ASSERT_EQ(unique_symbols.size(), kNumNames);
+	for (size_t t = 1; t < kNumThreads; ++t) {
+		ASSERT_EQ(results[t], results[0]);
+	}
+	ASSERT_EQ(pool.size(), kNumNames + 3);
+}
+
 } // namespace tests
@@ -5,13 +5,20 @@
  * @file tests/src/sys_ops_tests.cpp
  * @brief Definition of the test cases of the test suite SysOpsTests.
  */
+#include <algorithm>
 #include <filesystem>
 #include <string>
 
 #include <gtest/gtest.h>
 
 // Module(s) under Test
+#include "icarus/utils/async_file_writer.h"
+#include "icarus/utils/file_index.h"
+#include "icarus/utils/mapped_file.h"
+#include "icarus/utils/process.h"
+#include "icarus/utils/string_builder.h"
 #include "icarus/utils/system_ops.h"
+#include "icarus/utils/thread_pool.h"
 
 #include "project_fixtures.h"
 
@@ -97,4 +104,443 @@ TEST(SysOpsTests, IsValidFile) {
 	ASSERT_FALSE(utils::isValidFile(non_existing_file, "txt"));
 }
 
+/**
+ * @test Tests the scanning of a directory tree and the queries answered by the file index.
+ */
+TEST(SysOpsTests, FileIndex) {
+	fs::path root = kTestResutDir / "file_index";
+	fs::remove_all(root);
+	for (int i = 0; i < 10; ++i) {
+		fs::path dir = root / ("dir_" + std::to_string(i)) / "nested";
+		fs::create_directories(dir);
+		utils::writeStrToFile("a: " + std::to_string(i), (dir / "model.yaml").string());
+		utils::writeStrToFile("text", (dir.parent_path() / "notes.txt").string());
+	}
+	#ifdef __linux__
+		fs::create_directory_symlink(root / "dir_0", root / "link_to_dir_0");
+	#endif
+
+	utils::FileIndex index(root.string() + "/");
+	ASSERT_EQ(index.getRootDir(), fs::absolute(root).lexically_normal());
+	ASSERT_EQ(index.getFilesWithExtension("yaml").size(), 10);
+	ASSERT_EQ(index.getFilesWithExtension("txt").size(), 10);
+	ASSERT_TRUE(index.getFilesWithExtension("json").empty());
+
+	const utils::FileIndex::Entry* model = index.find("dir_3/nested/model.yaml");
+	ASSERT_NE(model, nullptr);
+	ASSERT_EQ(model->type, utils::FileIndex::EntryType::kFile);
+	ASSERT_EQ(model->size, 4);
+	ASSERT_EQ(model->mtime, fs::last_write_time(model->path));
+	ASSERT_EQ(index.find(root / "dir_3" / "nested" / "model.yaml"), model);
+	ASSERT_EQ(index.find("dir_3/nested/")->type, utils::FileIndex::EntryType::kDirectory);
+	ASSERT_EQ(index.resolve("dir_3/nested", "../notes.txt"), index.find("dir_3/notes.txt"));
+	ASSERT_EQ(index.resolve(root / "dir_5", (root / "dir_3" / "notes.txt").string()),
+			  index.find("dir_3/notes.txt"));
+
+	ASSERT_TRUE(index.isValidFile("dir_3/nested/model.yaml", "yaml"));
+	ASSERT_FALSE(index.isValidFile("dir_3/nested/model.yaml", "txt"));
+	ASSERT_FALSE(index.isValidFile("dir_3/nested", "yaml"));
+	ASSERT_FALSE(index.isValidFile("dir_3/missing.yaml", "yaml"));
+
+	#ifdef __linux__
+		// Links are indexed but not followed
+		ASSERT_EQ(index.find("link_to_dir_0")->type, utils::FileIndex::EntryType::kDirectory);
+		ASSERT_EQ(index.find("link_to_dir_0/notes.txt"), nullptr);
+	#endif
+
+	utils::writeStrToFile("new", (root / "new.txt").string());
+	ASSERT_EQ(index.find("new.txt"), nullptr);
+	index.rescan();
+	ASSERT_NE(index.find("new.txt"), nullptr);
+	ASSERT_THROW(utils::FileIndex(root / "new.txt"), std::runtime_error);
+}
+
+/**
+ * @test Tests the execution of tasks and the propagation of exceptions by a thread pool.
+ */
+TEST(SysOpsTests, ThreadPool) {
+	std::vector<std::future<int>> results;
+	{
+		utils::ThreadPool pool(3);
+		ASSERT_EQ(pool.getNumThreads(), 3);
+		for (int i = 0; i < 100; ++i) {
+			results.push_back(pool.submit([i]() { return 2 * i; }));
+		}
+
+		auto failing_task = pool.submit([]() -> int { throw std::runtime_error("Task failed"); });
+		ASSERT_THROW(failing_task.get(), std::runtime_error);
+
+		// Tasks can detect that they are executed by the pool
+		ASSERT_FALSE(pool.isWorkerThread());
+		ASSERT_TRUE(pool.submit([&pool]() { return pool.isWorkerThread(); }).get());
+		ASSERT_FALSE(utils::ThreadPool::getShared().isWorkerThread());
+	}
+
+	// All queued tasks are executed before the pool is destroyed
+	int sum = 0;
+	for (auto& result : results) {
+		sum += result.get();
+	}
+	ASSERT_EQ(sum, 9900);
+}
+
+/**
+ * @test Tests the writing of multiple buffers to a single file.
+ */
+TEST(SysOpsTests, WriteBuffersToFile) {
+	fs::create_directories(kTestResutDir);
+	std::string file_path = (kTestResutDir / "buffers.txt").string();
+
+	// More buffers than a single vectored write accepts
+	std::vector<std::string> lines;
+	std::vector<std::string_view> buffers;
+	std::string expected;
+	for (int i = 0; i < 2000; ++i) {
+		lines.push_back("line " + std::to_string(i) + "\n");
+		expected += lines.back();
+	}
+	buffers.assign(lines.begin(), lines.end());
+	buffers.push_back("");
+	utils::writeBuffersToFile(buffers, file_path);
+	ASSERT_EQ(utils::getFileContent(file_path), expected);
+
+	ASSERT_THROW(utils::writeBuffersToFile(buffers, (kTestResutDir / "missing" / "f.txt").string()),
+				 std::runtime_error);
+}
+
+/**
+ * @test Tests that unchanged files are not rewritten and that changed ones are replaced.
+ */
+TEST(SysOpsTests, WriteSkipUnchanged) {
+	fs::create_directories(kTestResutDir);
+	std::string file_path = (kTestResutDir / "skip_unchanged.txt").string();
+	fs::remove(file_path);
+
+	ASSERT_TRUE(utils::writeStrToFile("first\n", file_path, utils::WriteMode::kSkipUnchanged));
+	auto write_time = fs::last_write_time(file_path);
+	ASSERT_FALSE(utils::writeStrToFile("first\n", file_path, utils::WriteMode::kSkipUnchanged));
+	ASSERT_FALSE(utils::writeBuffersToFile({"fir", "st\n"}, file_path,
+										   utils::WriteMode::kSkipUnchanged));
+	ASSERT_EQ(fs::last_write_time(file_path), write_time);
+
+	// Same size but different content, and a prefix of the content
+	ASSERT_TRUE(utils::writeStrToFile("fir5t\n", file_path, utils::WriteMode::kSkipUnchanged));
+	ASSERT_EQ(utils::getFileContent(file_path), "fir5t\n");
+	ASSERT_TRUE(utils::writeStrToFile("fir", file_path, utils::WriteMode::kSkipUnchanged));
+	ASSERT_EQ(utils::getFileContent(file_path), "fir");
+
+	// Atomic writes leave no temporary files behind
+	ASSERT_TRUE(utils::writeStrToFile("atomic", file_path, utils::WriteMode::kAtomic));
+	ASSERT_EQ(utils::getFileContent(file_path), "atomic");
+	size_t num_files = 0;
+	for (const auto& entry : fs::directory_iterator(kTestResutDir)) {
+		num_files += (entry.path().filename().string().rfind("skip_unchanged", 0) == 0) ? 1 : 0;
+	}
+	ASSERT_EQ(num_files, 1);
+
+	// Atomic writes keep the permissions of the file and the symbolic links to it
+	fs::permissions(file_path, fs::perms::owner_read | fs::perms::owner_write);
+	std::string link_path = (kTestResutDir / "skip_unchanged_link.txt").string();
+	fs::remove(link_path);
+	fs::create_symlink(fs::absolute(file_path), link_path);
+	ASSERT_TRUE(utils::writeStrToFile("linked", link_path, utils::WriteMode::kAtomic));
+	ASSERT_TRUE(fs::is_symlink(link_path));
+	ASSERT_EQ(utils::getFileContent(file_path), "linked");
+	ASSERT_EQ(fs::status(file_path).permissions() & fs::perms::all,
+			  fs::perms::owner_read | fs::perms::owner_write);
+	fs::remove(link_path);
+}
+
+/**
+ * @test Tests the batched background writing of files, the flush barrier and errors.
+ */
+TEST(SysOpsTests, AsyncFileWriter) {
+	fs::path dir = kTestResutDir / "async_write";
+	fs::create_directories(dir);
+
+	utils::AsyncWriteOptions options;
+	options.num_threads = 3;
+	options.max_batch_size = 8;
+	options.is_synced = true;
+	std::vector<std::future<bool>> results;
+	{
+		utils::AsyncFileWriter writer(options);
+		for (int i = 0; i < 100; ++i) {
+			std::string content = writer.acquireBuffer();
+			ASSERT_TRUE(content.empty());
+			content.assign(5000, static_cast<char>('a' + i % 26));
+			results.push_back(writer.write((dir / ("file_" + std::to_string(i) + ".txt")).string(),
+										   std::move(content)));
+		}
+		results.push_back(writer.write((dir / "parts.txt").string(),
+									   std::vector<std::string>{"first ", "second"}));
+		writer.flush();
+		ASSERT_EQ(writer.getNumPending(), 0);
+		for (auto& result : results) {
+			ASSERT_EQ(result.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+			ASSERT_TRUE(result.get());
+		}
+		ASSERT_EQ(utils::getFileContent((dir / "file_27.txt").string()), std::string(5000, 'b'));
+		ASSERT_EQ(utils::getFileContent((dir / "parts.txt").string()), "first second");
+
+		// Written buffers are reused
+		ASSERT_GE(writer.acquireBuffer().capacity(), 5000);
+
+		std::future<bool> failed = writer.write((dir / "missing" / "f.txt").string(), "x");
+		ASSERT_THROW(failed.get(), std::runtime_error);
+
+		// Queued files are written on destruction
+		writer.write((dir / "last.txt").string(), "last");
+	}
+	ASSERT_EQ(utils::getFileContent((dir / "last.txt").string()), "last");
+
+	// Atomic writes are synced together with their directory
+	options = utils::AsyncWriteOptions();
+	options.mode = utils::WriteMode::kSkipUnchanged;
+	options.is_synced = true;
+	utils::AsyncFileWriter writer(options);
+	ASSERT_FALSE(writer.write((dir / "last.txt").string(), "last").get());
+	ASSERT_TRUE(writer.write((dir / "last.txt").string(), "changed").get());
+	ASSERT_EQ(utils::getFileContent((dir / "last.txt").string()), "changed");
+}
+
+/**
+ * @test Tests the merging of files and the chunked string builder.
+ */
+TEST(SysOpsTests, StringBuilder) {
+	fs::create_directories(kTestResutDir);
+	std::string part_a = (kTestResutDir / "builder_a.txt").string();
+	std::string part_b = (kTestResutDir / "builder_b.txt").string();
+	std::string large(100000, 'x');
+	utils::writeStrToFile("first", part_a);
+	utils::writeStrToFile(large, part_b);
+	ASSERT_EQ(utils::getMergedContent({part_a, part_b}), "first\n" + large + "\n");
+	ASSERT_THROW(utils::getMergedContent({part_a, (kTestResutDir / "missing.txt").string()}),
+				 std::runtime_error);
+
+	// Small appends share chunks, large strings and files become chunks of their own
+	utils::StringBuilder builder(16);
+	std::string expected;
+	for (int i = 0; i < 100; ++i) {
+		builder << "line " << std::to_string(i) << '\n';
+		expected += "line " + std::to_string(i) + "\n";
+	}
+	builder.append("literal ");
+	builder.append(std::string(large));
+	builder.appendFile(part_a);
+	expected += "literal " + large + "first";
+	ASSERT_EQ(builder.size(), expected.size());
+	ASSERT_EQ(builder.toString(), expected);
+	ASSERT_GT(builder.getBuffers().size(), 1);
+
+	std::string file_path = (kTestResutDir / "builder.txt").string();
+	ASSERT_TRUE(builder.writeToFile(file_path));
+	ASSERT_EQ(utils::getFileContent(file_path), expected);
+	ASSERT_FALSE(builder.writeToFile(file_path, utils::WriteMode::kSkipUnchanged));
+
+	builder.clear();
+	ASSERT_TRUE(builder.empty());
+	ASSERT_EQ(builder.toString(), "");
+}
+
+/**
+ * @test Tests the reading and mapping of files, including empty and size-less files.
+ */
+TEST(SysOpsTests, MappedFile) {
+	fs::create_directories(kTestResutDir);
+	std::string file_path = (kTestResutDir / "mapped.txt").string();
+	std::string content;
+	for (int i = 0; i < 100000; ++i) {
+		content += "line " + std::to_string(i) + "\n";
+	}
+	utils::writeStrToFile(content, file_path);
+	ASSERT_EQ(utils::getFileContent(file_path), content);
+
+	utils::MappedFile mapped(file_path, utils::MappedFile::AccessHint::kSequential, true);
+	ASSERT_EQ(mapped.getView(), content);
+	utils::MappedFile moved(std::move(mapped));
+	ASSERT_EQ(moved.size(), content.size());
+	ASSERT_EQ(moved.getView(), content);
+	ASSERT_TRUE(mapped.empty());
+
+	std::string empty_path = (kTestResutDir / "mapped_empty.txt").string();
+	utils::writeStrToFile("", empty_path);
+	ASSERT_EQ(utils::getFileContent(empty_path), "");
+	utils::MappedFile empty(empty_path);
+	ASSERT_TRUE(empty.empty());
+	ASSERT_FALSE(empty.isMapped());
+
+	ASSERT_THROW(utils::MappedFile((kTestResutDir / "missing.txt").string()), std::runtime_error);
+	ASSERT_THROW(utils::getFileContent((kTestResutDir / "missing.txt").string()), std::runtime_error);
+
+	// A failed read leaves the appended string unchanged
+	std::string appended = "prefix";
+	ASSERT_THROW(utils::appendFileContent(kTestResutDir.string(), appended), std::runtime_error);
+	ASSERT_EQ(appended, "prefix");
+
+#ifdef __linux__
+	// Files reporting a size of zero are read until their end
+	ASSERT_NE(utils::getFileContent("/proc/self/status").find("Name:"), std::string::npos);
+	utils::MappedFile proc_file("/proc/self/status");
+	ASSERT_FALSE(proc_file.isMapped());
+	ASSERT_NE(proc_file.getView().find("Name:"), std::string::npos);
+#endif
+}
+
+/**
+ * @test Tests the asynchronous reading of file lists with futures and in completion order.
+ */
+TEST(SysOpsTests, ReadFilesAsync) {
+	fs::create_directories(kTestResutDir / "async_read");
+	std::vector<std::string> file_paths;
+	for (int i = 0; i < 50; ++i) {
+		file_paths.push_back((kTestResutDir / "async_read" / ("file_" + std::to_string(i) + ".txt")).string());
+		utils::writeStrToFile("content " + std::to_string(i), file_paths.back());
+	}
+
+	std::vector<std::future<std::string>> contents = utils::readFilesAsync(file_paths);
+	ASSERT_EQ(contents.size(), file_paths.size());
+	for (size_t i = 0; i < contents.size(); ++i) {
+		ASSERT_EQ(contents[i].get(), "content " + std::to_string(i));
+	}
+
+	// Each file is delivered exactly once, errors are passed with the result
+	file_paths.push_back((kTestResutDir / "async_read" / "missing.txt").string());
+	std::vector<int> num_delivered(file_paths.size(), 0);
+	size_t num_errors = 0;
+	utils::readFilesAsync(file_paths, [&](utils::FileReadResult&& result) {
+		++num_delivered[result.index];
+		if (result.error) {
+			++num_errors;
+			ASSERT_THROW(std::rethrow_exception(result.error), std::runtime_error);
+		}
+		else {
+			ASSERT_EQ(result.content, "content " + std::to_string(result.index));
+		}
+	});
+	ASSERT_EQ(num_errors, 1);
+	ASSERT_EQ(std::count(num_delivered.begin(), num_delivered.end(), 1), file_paths.size());
+	std::vector<std::future<std::string>> failed = utils::readFilesAsync({file_paths.back()});
+	ASSERT_THROW(failed[0].get(), std::runtime_error);
+
+	// Exceptions of the callback are rethrown after all reads completed
+	ASSERT_THROW(utils::readFilesAsync(file_paths, [](utils::FileReadResult&&) {
+		throw std::runtime_error("callback");
+	}), std::runtime_error);
+}
+
+#ifdef __linux__
+/**
+ * @test Tests running processes with arguments, stdin, captured streams and timeouts.
+ */
+TEST(SysOpsTests, RunProcess) {
+	// Arguments are passed without shell interpretation
+	utils::ProcessResult result = utils::runProcess({"echo", "$HOME", "a  b"});
+	ASSERT_EQ(result.exit_code, 0);
+	ASSERT_EQ(result.stdout_data, "$HOME a  b\n");
+
+	// Large stdin and stdout are served concurrently
+	utils::ProcessOptions options;
+	options.stdin_data = std::string(1 << 20, 'x');
+	result = utils::runProcess({"cat"}, options);
+	ASSERT_EQ(result.stdout_data, *options.stdin_data);
+
+	result = utils::runProcess({"sh", "-c", "echo out; echo err >&2; exit 3"});
+	ASSERT_EQ(result.exit_code, 3);
+	ASSERT_EQ(result.stdout_data, "out\n");
+	ASSERT_EQ(result.stderr_data, "err\n");
+
+	options = utils::ProcessOptions();
+	options.stderr_mode = utils::StreamMode::kDiscard;
+	options.timeout = std::chrono::milliseconds(100);
+	result = utils::runProcess({"sh", "-c", "echo err >&2; exec sleep 5"}, options);
+	ASSERT_TRUE(result.is_timed_out);
+	ASSERT_EQ(result.exit_code, -1);
+	ASSERT_NE(result.signal, 0);
+	ASSERT_EQ(result.stderr_data, "");
+
+	// Timeout of a process that closed its streams
+	options.stdout_mode = utils::StreamMode::kDiscard;
+	result = utils::runProcess({"sleep", "5"}, options);
+	ASSERT_TRUE(result.is_timed_out);
+
+	ASSERT_THROW(utils::runProcess({"non_existing_command"}), std::runtime_error);
+	ASSERT_THROW(utils::runProcess({}), std::runtime_error);
+
+	// Concurrent processes
+	std::vector<std::future<utils::ProcessResult>> results;
+	for (int i = 0; i < 8; ++i) {
+		results.push_back(utils::runProcessAsync({"echo", std::to_string(i)}));
+	}
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_EQ(results[i].get().stdout_data, std::to_string(i) + "\n");
+	}
+}
+
+/**
+ * @test Tests the bounded concurrent execution, timing and cancellation of process batches.
+ */
+TEST(SysOpsTests, ProcessPool) {
+	utils::ProcessPool pool(4);
+	ASSERT_EQ(pool.getMaxJobs(), 4);
+	ASSERT_GE(utils::ProcessPool::getDefaultNumJobs(), 1);
+
+	std::vector<std::future<utils::ProcessResult>> results;
+	for (int i = 0; i < 16; ++i) {
+		results.push_back(pool.submit({"sh", "-c", "exit " + std::to_string(i % 3)}));
+	}
+	pool.wait();
+	for (int i = 0; i < 16; ++i) {
+		utils::ProcessResult result = results[i].get();
+		ASSERT_EQ(result.exit_code, i % 3);
+		ASSERT_GT(result.wall_time.count(), 0);
+	}
+
+	// Output streamed in chunks instead of collected
+	std::string streamed;
+	utils::ProcessOptions options;
+	options.stdout_sink = [&streamed](std::string_view chunk) { streamed.append(chunk); };
+	utils::ProcessResult result = pool.submit({"seq", "1", "10000"}, options).get();
+	ASSERT_TRUE(result.stdout_data.empty());
+	ASSERT_EQ(streamed.substr(0, 4), "1\n2\n");
+	ASSERT_EQ(streamed.size(), 48894);
+
+	// Cancellation kills running processes and drops queued ones
+	results.clear();
+	for (int i = 0; i < 8; ++i) {
+		results.push_back(pool.submit({"sleep", "5"}));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	auto start = std::chrono::steady_clock::now();
+	pool.cancel();
+	ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+	for (auto& cancelled : results) {
+		ASSERT_TRUE(cancelled.get().is_cancelled);
+	}
+	ASSERT_EQ(pool.submit({"true"}).get().exit_code, 0);
+}
+
+/**
+ * @test Tests the default number of jobs from the job limit of make.
+ */
+TEST(SysOpsTests, ProcessPoolMakeJobs) {
+	const char* make_flags = std::getenv("MAKEFLAGS");
+	std::optional<std::string> saved_flags;
+	if (make_flags != nullptr) {
+		saved_flags = make_flags;
+	}
+
+	setenv("MAKEFLAGS", " -j3 --jobserver-auth=3,4", 1);
+	ASSERT_EQ(utils::ProcessPool::getDefaultNumJobs(), 3);
+	setenv("MAKEFLAGS", "--no-print-directory --jobs=5", 1);
+	ASSERT_EQ(utils::ProcessPool::getDefaultNumJobs(), 5);
+	unsetenv("MAKEFLAGS");
+	ASSERT_EQ(utils::ProcessPool::getDefaultNumJobs(), std::max(1u, std::thread::hardware_concurrency()));
+
+	if (saved_flags) {
+		setenv("MAKEFLAGS", saved_flags->c_str(), 1);
+	}
+}
+#endif
+
 } // namespace tests